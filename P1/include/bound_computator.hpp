@@ -16,6 +16,12 @@
  *      - The length of an MST on a given terminal set
  *      - The bounding box lower bound BB(v, I) of a label.
  *      - The One-Tree lower bound MST(v, I) of a label.
+ *      - The exact length of a Steiner tree on {v} u R-I for labels
+ *        (v, I) with |R-I| <= 3, which both bounds above return instead 
+ *        for such labels.
+ *      - The dual ascent lower bound of a label, see dual_ascent.hpp.
+ *      - The bounding box lower bound of a label, combined with the 
+ *        One-Tree lower bound if its terminal set is large enough.
  *
  *      - A local upper bound U(I) for a bitset I given a label
  *        (v, I).
@@ -27,8 +33,12 @@
  *      - The vertex / terminal attaining these minimum distances.
  *  
  * In order to efficiently make use of / look up previous computational
- * results, BoundComputator contains hash tables using bitsets
- * as keys, containing MST(I), A(I), d(I, R-I).
+ * results, BoundComputator stores A(I), d(I, R-I) and MST(R-I) for each
+ * terminal set I in a single record of a SubsetTable, see 
+ * subset_table.hpp. MSTs are computed by an MSTEngine, see mst_engine.hpp.
+ * Optionally, d(I, R-I) and MST(R-I) are computed in advance on a worker
+ * thread for the terminal sets of labels created by merges, which are
+ * only needed once these labels are popped, see subset_prefetcher.hpp.
  *
  *
  * BoundComputator makes the same assumptions on the given instance
@@ -55,14 +65,22 @@
 #include "vertex.hpp"
 #include "instance.hpp"
 #include "label.hpp"
+#include "simd.hpp"
+#include "mst_engine.hpp"
+#include "nearest_terminals.hpp"
+#include "subset_table.hpp"
+#include "thread_pool.hpp"
+#include "dual_ascent.hpp"
+#include "subset_prefetcher.hpp"
 #include <stdlib.h>
+#include <stdint.h>
 #include <vector>
 #include <bitset>
 #include <climits>
-#include <unordered_map>
 #include <set>
 #include <utility>
 #include <iterator>
+#include <algorithm>
 
 using namespace std;
 
@@ -70,10 +88,19 @@ using namespace std;
 class Label;
 class Vertex;
 class Instance;
+class DualAscent;
 
 struct BoundOptions {
     bool _use_BB_lower_bound;
     bool _use_onetree_lower_bound;
+    bool _use_dual_ascent_lower_bound;
+    bool _lazy_lower_bound;             // See LazyBoundPolicy.
+    bool _adaptive_lower_bound;         // See AdaptiveBoundPolicy.
+    bool _prefetch_subsets;             // See subset_prefetcher.hpp.
+    NearestMode _nearest_mode;          // See nearest_terminals.hpp.
+    uint64_t _nearest_max_memory;       // 0 means the default bound.
+    SubsetMode _subset_mode;            // See subset_table.hpp.
+    uint64_t _subset_max_memory;        // 0 means the default bound.
 };
 
 struct PerimeterCoords {
@@ -93,34 +120,63 @@ class BoundComputator {
         Vertex **_terminals;    // References to the terminals in 
                                 // the underlying instance.
 
+        /* The coordinates of the terminals as a structure of arrays,
+         * padded and aligned for the SIMD kernels in simd.hpp. */
+        int32_t *_terminal_x;
+        int32_t *_terminal_y;
+        int32_t *_terminal_z;
+        uint64_t _terminal_mask;    // Mask containing all terminals.
+
+        /* For each axis, the coordinates of the terminals in increasing
+         * order, and tables to find the ranks of the terminals in a
+         * terminal set in this order. See RankMask. */
+        int32_t _sorted_coords[3][BITSET_SIZE];
+        int _sorted_terminals[3][BITSET_SIZE];  // Terminal of each rank.
+        uint64_t *_rank_tables;
+        int _n_rank_bytes;      // Number of bytes in a terminal mask.
+
         bool _use_BB_lower_bound;           // Use Bounding Box lb?
         bool _use_onetree_lower_bound;      // Use 1-Tree lb?
+        bool _use_dual_ascent_lower_bound;  // Use dual ascent lb?
+        bool _lazy_lower_bound;     // Only use BB until a label is popped?
+        bool _adaptive_lower_bound; // Let the solver pick the bound?
 
-        /* Hash table containing MST(R-I) for a terminal set I, if 
-         * it has been computed already. */
-        unordered_map<bitset<BITSET_SIZE>, int> _MST_hash;
-
-        /* Hash table containing (d(I, R-I), i) for a terminal set I, if 
-         * it has been computed already, where i is the index of the terminal
-         * in R-I minimizing d(i, I). */
-        unordered_map<bitset<BITSET_SIZE>, pair<int, int> > _distance_hash;
-    
-        /* Hash table containing pairs A(I) = (U(I), S(I)), where 
-         * U(I) is the current upper bound for a terminals set I, and 
-         * S(I) is the set of terminals used to find U(I). */
-        unordered_map<bitset<BITSET_SIZE>, pair<int, bitset<BITSET_SIZE> > > 
-        _upper_bound_hash;
-
-        /* Hash table containg pairs (x_max, x_min, y_max, y_min) for 
-         * a terminal set I. */
-        unordered_map<bitset<BITSET_SIZE>, PerimeterCoords> _perimeter_hash;
-
-        /* Find the distance d(I, R-I) between a terminal set and its
-         * complement, as well as the index of the terminal i in R-I 
-         * minimizing d(i, I) either by fetching these values from the
-         * hash table if possible, or computing them. After a 
-         * compputation the results are stored in _distance_hash. */
-        Result GetComplementDistance(const bitset<BITSET_SIZE> &I,
+        /* Smallest size of a terminal set I for which AdaptiveLowerBound
+         * uses the 1-tree lower bound. */
+        int _onetree_min_size;
+
+        /* The dual ascent on the grid of the instance, once it has been
+         * computed by ComputeDualAscent. NULL before that, or if the 
+         * dual ascent lower bound is not used. */
+        DualAscent *_dual_ascent;
+
+        /* Computes and caches MSTs on terminal sets. */
+        MSTEngine *_mst_engine;
+
+        /* Lists of terminals ordered by distance for each vertex, used
+         * to find d(v, R-I). NULL if these are not used. */
+        NearestTerminals *_nearest_terminals;
+
+        /* Table containing for a terminal set I the pair A(I) = (U(I), 
+         * S(I)), where U(I) is the current upper bound for I and S(I) is
+         * the set of terminals used to find U(I), as well as d(I, R-I) 
+         * with the index of the terminal in R-I minimizing d(i, I), and
+         * MST(R-I), for as far as these have been computed. */
+        SubsetTable *_subset_table;
+        bool _precompute_subset_table;  // Fill the table in advance?
+
+        /* Computes values for the subset table on a worker thread, and a
+         * buffer for its results. NULL if this is not done. */
+        SubsetPrefetcher *_prefetcher;
+        vector<PrefetchedSubset> _prefetched;
+
+
+        /* Find the distance d(I, R-I) between the terminal set I of the
+         * given record and its complement, as well as the index of the 
+         * terminal i in R-I minimizing d(i, I) either by fetching these
+         * values from the record if possible, or computing them. After a 
+         * computation the results are stored in the record. */
+        Result GetComplementDistance(SubsetRecord *r,
                                      int &ret_dist,
                                      int &ret_ind);
 
@@ -128,21 +184,50 @@ class BoundComputator {
          * complement, as well as the index of the terminal i in R-I 
          * minimizing d(i, I) in O(|I||R-I|). */
         Result ComplementDistance(const bitset<BITSET_SIZE> &I, 
-                                  int &ret_dist,
-                                  int &ret_ind);
+                                  int32_t &ret_dist,
+                                  int32_t &ret_ind);
 
         /* Compute the distance d(v, R-I) between a vertex and the 
          * complement ofthe given terminal set, as well as the index 
-         * of the terminal i in R-I minimizing d(v, i) in O(|R-I|). */
+         * of the terminal i in R-I minimizing d(v, i). This takes 
+         * O(|R-I|), unless the nearest terminal lists are used. */
         Result VertexComplementDistance(const bitset<BITSET_SIZE> &I,
                                         Vertex *v, 
                                         int &ret_dist, 
                                         int &ret_ind);
 
+        /* Write the distance between v and the i-th terminal to
+         * ret_dists[i] for all i. ret_dists should have room for 
+         * BITSET_SIZE integers. */
+        Result TerminalDistances(Vertex *v, int32_t *ret_dists);
+
+        /* Sort the terminals along each axis and fill the rank tables,
+         * such that the entry for axis a, byte b and value m is the mask
+         * of ranks along a of the terminals 8b + j for the bits j of m. */
+        Result SetRankTables();
+
+        /* Return the mask of ranks along the given axis of the terminals
+         * in I, by or-ing the table entries for each byte of I. */
+        inline uint64_t RankMask(int axis, uint64_t I) const {
+            const uint64_t *table = _rank_tables + axis * _n_rank_bytes * 256;
+            uint64_t ret = 0;
+            for (int byte = 0; byte < _n_rank_bytes; byte++)
+                ret |= table[(byte << 8) | ((I >> (8 * byte)) & 0xFF)];
+            return ret;
+        }
+
+        /* Return MST(R-I), fetching it from the subset table if possible,
+         * and computing it with the MST engine and storing it otherwise. */
+        int GetComplementMST(const bitset<BITSET_SIZE> &I);
+
     public:
         /* Return l(v, I) > U(I), the local upper bound for I. */
         bool CompareToUpperBound(Label *l);
 
+        /* Return l > U(I) for a value l that a (possibly not yet 
+         * created) label (v, I) would get. */
+        bool CompareToUpperBound(const bitset<BITSET_SIZE> &I, int l);
+
         /* Update the local upper bound U(I) given a label of the form 
          * (v, I) by setting 
          *     U(I) = min(U(I), l(v,I) + min(d(v, R-I), d(I, R-I))).
@@ -150,6 +235,12 @@ class BoundComputator {
          * is the label minimizing l(v, I) + lb(v, I) among all labels
          * not in P. */
         Result UpdateUpperBound(Label *l);
+
+        /* Update U(I) in the same way, given a tree of length l that 
+         * connects the terminals in I and the vertex v, e.g. a subtree
+         * of a heuristic Steiner tree. */
+        Result UpdateUpperBound(const bitset<BITSET_SIZE> &I, Vertex *v, 
+                                int l);
         
         /* Update the local upper bound U(I u J) given two terminal sets
          * I and J with I \cap S(J) or J \cap S(I) empty by setting:
@@ -159,35 +250,170 @@ class BoundComputator {
         Result MergeUpperBound(const bitset<BITSET_SIZE> &I,
                                const bitset<BITSET_SIZE> &J);
 
-        /* Constructor */
+        /* Constructor / Destructor */
         BoundComputator(Instance *inst, BoundOptions *opts);
+        ~BoundComputator();
 
-        /* Compute the coordinates of the perimeter of I, that is
-         * x_max, x_min, y_max, y_min, z_max, z_min for I. */
+        /* Compute the coordinates of the perimeter of R-I, that is
+         * x_max, x_min, y_max, y_min, z_max, z_min for R-I, in constant
+         * time using the rank tables. */
         PerimeterCoords Perimeter(const bitset<BITSET_SIZE> &I);
 
-        /* Compute the bounding box length BB({v} u I) for the given (v, I)
-         * The required perimeter of I is fetched from the hash table if
-         * possible, and computed otherwise. */
+        /* Compute the bounding box length BB({v} u R-I) for the given 
+         * label (v, I), or SmallSteinerLength(v, R-I) if |R-I| = 3. */
         int BBLowerBound(Label *l);
 
+        /* Return the length of a shortest rectilinear Steiner tree on 
+         * {v} u C for a set C of three terminals, in constant time. The
+         * tree has (up to) two Steiner points s, s' with s adjacent to v 
+         * and a terminal a of C, and s' to the other two terminals b, c.
+         * Its length splits into one term per axis, which for the 
+         * coordinates x_1 <= x_2 <= x_3 <= x_4 of the four points is
+         * x_4 - x_1 if {v, a} and {b, c} are on opposite sides of the 
+         * median interval [x_2, x_3], and x_4 - x_1 + x_3 - x_2 
+         * otherwise. We take the best choice of a. The minimum, median 
+         * and maximum of C along each axis are found using the rank 
+         * tables. For |C| <= 2 the bounding box is exact already. */
+        int SmallSteinerLength(Vertex *v, uint64_t C) const;
+
         /* Compute the length of an MST on the given terminal set using
-         * Prim's algorithm running in O(|R|^2). */
+         * Prim's algorithm running in O(|R|^2), without caching it. */
         int MST(const bitset<BITSET_SIZE> &I);
 
         /* Compute the 1-tree lower bound for the given label (v, I). 
-         * The required value MST(I) is fetched from the hash table if 
-         * possible, and computed otherwise. */
+         * The required value MST(R-I) is fetched from the subset table
+         * if possible, and computed otherwise. If |R-I| <= 3, return the
+         * exact BBLowerBound instead, which is at least as large. */
         int OneTreeLowerBound(Label *l);
 
+        /* Return the dual ascent lower bound for the given label (v, I).
+         * ComputeDualAscent should have been called before. */
+        int DualAscentLowerBound(Label *l);
+
+        /* Return BB(v, I) for the given label (v, I) if |I| is smaller 
+         * than the size set by SetOneTreeMinSize, and the maximum of 
+         * BB(v, I) and the 1-tree lower bound otherwise. Since labels 
+         * (v, I u J) then never get a weaker bound than (v, I), this 
+         * bound is consistent for every size. */
+        int AdaptiveLowerBound(Label *l);
+
+        /* If the dual ascent lower bound is used, run the dual ascent on
+         * the current grid of the instance. This should be called once,
+         * after vertices have been removed from the grid and before any 
+         * lower bounds are computed. Return FAIL if nothing is to be 
+         * done. */
+        Result ComputeDualAscent();
+
         /* Return the lb(v, I) for the given label, where lb is 
          * a lower bound function determined by the values of 
-         * _use_BB_lower_bound and _use_MST_lower_bound. */
+         * _use_BB_lower_bound, _use_MST_lower_bound and 
+         * _use_dual_ascent_lower_bound. The solver 
+         * instead uses the lower bound policy matching these values, 
+         * see below, which avoids checking them for every label. */
         int GetLowerBound(Label *l);
 
+        /* Make sure that all values the lower bound policy matching the
+         * options needs when adding labels (v, I) with the given terminal
+         * set I to N are cached. With a lazy bound these are only the 
+         * values of the cheap bound. After this, the policy only reads 
+         * from the caches for such labels, so several threads may compute
+         * it at the same time, as long as no other method is called 
+         * meanwhile. */
+        Result PrepareLowerBound(const bitset<BITSET_SIZE> &I);
+
+        /* Ask the prefetcher to compute d(I, R-I), and MST(R-I) if the 
+         * 1-tree lower bound is lazy, for the given terminal set I, 
+         * unless these are known already. Return FAIL if nothing is to 
+         * be done. */
+        Result PrefetchSubset(const bitset<BITSET_SIZE> &I);
+
+        /* Store the values computed by the prefetcher so far in the 
+         * subset table, where they are not yet set. Return FAIL if there
+         * were none. Like FindOrInsert, this may move the records. */
+        Result StorePrefetchedSubsets();
+
+        /* If the subset table is dense and should be filled in advance,
+         * compute d(I, R-I) and (if the 1-tree lower bound is used) 
+         * MST(R-I) for every terminal set I, using the threads of the 
+         * given pool, or only the calling thread if it is NULL. Return 
+         * FAIL if nothing is to be done. */
+        Result PrecomputeSubsetTable(ThreadPool *pool);
+
         /* Getters / Setters. */
         Result SetUseBBLowerBound();
         Result SetUseOneTreeLowerBound();
+        bool GetUseBBLowerBound() const;
+        bool GetUseOneTreeLowerBound() const;
+        bool GetUseDualAscentLowerBound() const;
+        bool GetLazyLowerBound() const;
+        bool GetAdaptiveLowerBound() const;
+        Result SetOneTreeMinSize(int size);
+        int GetOneTreeMinSize() const;
+        DualAscent *GetDualAscent() const;
+        const SubsetTable *GetSubsetTable() const;
+        const MSTEngine *GetMSTEngine() const;
+        const NearestTerminals *GetNearestTerminals() const;
+};
+
+/* Lower bound policies. Each policy has a static method Compute that 
+ * returns lb(v, I) for a label (v, I), using a fixed lower bound function.
+ * Code that is templated on a policy (such as the main loop of Solver) 
+ * therefore does not need to check which lower bound is used for every
+ * label, and the compiler can inline the bound. A new lower bound only
+ * needs a policy here and a case in Solver::SolveCurrentInstance. */
+struct NoBoundPolicy {
+    static inline int Compute(BoundComputator *, Label *) { return 0; }
+};
+
+struct BBBoundPolicy {
+    static inline int Compute(BoundComputator *bc, Label *l) {
+        return bc->BBLowerBound(l);
+    }
+};
+
+struct OneTreeBoundPolicy {
+    static inline int Compute(BoundComputator *bc, Label *l) {
+        return bc->OneTreeLowerBound(l);
+    }
+};
+
+struct DualAscentBoundPolicy {
+    static inline int Compute(BoundComputator *bc, Label *l) {
+        return bc->DualAscentLowerBound(l);
+    }
+};
+
+/* The bound of AdaptiveLowerBound, for which Solver::SolveAdaptive 
+ * chooses the smallest terminal sets that get the 1-tree lower bound 
+ * during the search. */
+struct AdaptiveBoundPolicy {
+    static inline int Compute(BoundComputator *bc, Label *l) {
+        return bc->AdaptiveLowerBound(l);
+    }
+};
+
+/* The maximum of the bounds of two policies. */
+template <class FirstBound, class SecondBound>
+struct MaxBoundPolicy {
+    static inline int Compute(BoundComputator *bc, Label *l) {
+        return max(FirstBound::Compute(bc, l), SecondBound::Compute(bc, l));
+    }
+};
+
+/* The bound of a cheap policy when a label is added to N, refined to the
+ * maximum with the bound of a strong policy when the label reaches the top
+ * of N, after which the label is added to N again if its key increased. 
+ * The strong bound is thus only computed for labels that are popped, and 
+ * at most once per label. Since the cheap bound is at most the strong 
+ * bound and the strong bound is consistent, labels are still only moved 
+ * to P with their final value: a label (w, J) in N whose key is at least
+ * that of (v, I) cannot improve l(v, I). The refinement is done by 
+ * BoundRefinement, see solver.hpp. */
+template <class CheapBound, class StrongBound>
+struct LazyBoundPolicy {
+    static inline int Compute(BoundComputator *bc, Label *l) {
+        return CheapBound::Compute(bc, l);
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,148 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * dual_ascent.hpp
+ *
+ *
+ * DualAscent is a class that, given an Instance, computes a lower bound
+ * for the length of a Steiner tree in its (reduced) Hanan grid using the
+ * dual ascent algorithm of Wong (1984). The grid is seen as a directed
+ * graph with an arc in both directions for every edge, and a Steiner
+ * tree as an arborescence rooted at the root terminal r. Every vertex set
+ * W containing a terminal but not r is then entered by an arc of every
+ * such arborescence, which gives the dual constraints
+ *      sum_{W entered by a} y_W <= c(a)        for every arc a.
+ * Starting from y = 0, the algorithm repeatedly picks a terminal t whose
+ * component W(t), the set of vertices from which t can be reached using
+ * arcs of reduced cost c~(a) = c(a) - sum_{W entered by a} y_W equal to
+ * zero, does not contain r, and raises y_W(t) until an arc entering W(t)
+ * has reduced cost zero. Components are picked in order of their size
+ * when they were last raised. The sum of all y_W is a lower bound, and
+ * the reduced costs are kept.
+ *
+ * Since the reduced costs are non-negative, every arborescence A rooted
+ * at r has length at least c~(A) + the sum of y_W over all W it enters.
+ * This gives:
+ *
+ *      - A lower bound for labels (v, I): the remaining tree connecting v
+ *        and R-I contains a path from r to v and enters every W that
+ *        contains v or a terminal in R-I, so its length is at least
+ *              d~(r, v) + sum_{W : v in W or W meets R-I} y_W,
+ *        where d~ is the distance w.r.t. the reduced costs. This bound is
+ *        consistent, i.e. lb(v, I) <= c(v, w) + lb(w, I) for neighbours
+ *        v, w and lb(v, I) <= smt(J u {v}) + lb(v, I u J), since a tree
+ *        connecting J and v enters every W that contains a terminal of J
+ *        but not v.
+ *      - A test to remove vertices and edges before the search: a
+ *        non-terminal vertex v is in no tree of length at most U if
+ *              sum y_W + d~(r, v) + d~(v, R) > U,
+ *        and an arc (u, w) is in no such tree if
+ *              sum y_W + d~(r, u) + c~(u, w) + d~(w, R) > U.
+ *
+ * The components W(t) of a single terminal t only grow, so the sets W
+ * raised for t are nested. For each terminal t we store the values y_W
+ * in the order in which they were raised as prefix sums, the terminals
+ * in these sets, and for each vertex v the first set containing it. Then
+ * the sum over all W that contain neither v nor a terminal in R-I (i.e.
+ * whose terminals are all in I) is a sum of one prefix per terminal in I.
+ * Detailed explanations of DualAscent's members and methods can be found
+ * below in the declarations.
+ *
+ *
+ * DualAscent makes the same assumptions on the given instance Solver
+ * does. Vertices may be removed from the instance after the dual ascent
+ * has been run, as long as the IDs of the other vertices do not change.
+ */
+
+#ifndef DUAL_ASCENT_HPP
+#define DUAL_ASCENT_HPP
+
+#include "util.hpp"
+#include "vertex.hpp"
+#include "instance.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <climits>
+
+using namespace std;
+
+/* Index of the first set containing a vertex that is in no set. */
+#define DUAL_NOT_ENTERED INT_MAX
+
+/* Forward declarations. */
+class Vertex;
+class Instance;
+
+/* A maximal range of sets raised for a terminal that contain the same
+ * terminals, starting at the set with the given index. */
+struct DualSegment {
+    int _begin;
+    uint64_t _mask;
+};
+
+class DualAscent {
+    private:
+        Instance *_problem_instance;    // The underlying problem instance.
+        int _n_terminals;               // Number of terminals.
+        int _n_ids;                     // One more than the largest ID.
+        vector<int> _terminal_index;    // Index of terminal with ID, or -1.
+
+        /* The arcs. The arcs entering the vertex with ID x are those with
+         * positions _in_begin[x], ..., _in_begin[x + 1] - 1, and
+         * _out_arcs[_out_begin[u]], ... are the positions of the arcs
+         * leaving the vertex with ID u. */
+        vector<int> _in_begin;
+        vector<int> _out_begin;
+        vector<int> _out_arcs;
+        vector<int> _arc_tail;          // ID of the tail of each arc.
+        vector<int> _arc_head;          // ID of the head of each arc.
+        vector<int> _reduced_costs;     // c~ of each arc.
+
+        int _lower_bound;               // The sum of all y_W.
+
+        /* For each terminal t, _prefix_sums[t][k] is the sum of y_W over
+         * the first k sets raised for t, _segments[t] lists the ranges of
+         * these sets containing the same terminals, and
+         * _entries[t * _n_ids + x] is the index of the first set that
+         * contains the vertex with ID x. */
+        vector<vector<int> > _prefix_sums;
+        vector<vector<DualSegment> > _segments;
+        vector<int> _entries;
+
+        /* Reduced distances d~(r, x) and d~(x, R) of each vertex by ID. */
+        vector<int> _root_distances;
+        vector<int> _terminal_distances;
+
+        /* Compute _root_distances and _terminal_distances by Dijkstra's
+         * algorithm on the reduced costs. */
+        Result ComputeDistances();
+
+    public:
+        /* Constructor. Sets up the arcs of the current grid of the given
+         * instance, but does not run the dual ascent yet. */
+        DualAscent(Instance *problem_instance);
+
+        /* Run the dual ascent. */
+        Result Run();
+
+        /* Return the sum of all y_W, a lower bound for the instance. */
+        int GetLowerBound() const;
+
+        /* Return the lower bound for the label (v, I) described above. */
+        int LabelLowerBound(Vertex *v, uint64_t I) const;
+
+        /* Remove all vertices and edges of the instance that are in no
+         * tree of length at most upper_bound according to the test
+         * described above, as well as vertices of low degree, see
+         * Instance::RemoveVertices. Return the number of removed
+         * vertices and edges in ret_n_vertices and ret_n_edges. */
+        Result EliminateVertices(int upper_bound, int &ret_n_vertices,
+                                 int &ret_n_edges);
+};
+
+#endif
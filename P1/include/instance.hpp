@@ -23,8 +23,14 @@
  *
  * Furthermore, Instance will provide each of the vertices it produces with
  * a unique integer ID, as well as a all of the vertex's neighbours in 
- * the Hanan grid. Detailed explanations of each of Instance's members and 
- * methods are found in the declarations below.
+ * the Hanan grid. 
+ *
+ * Optionally, the Hanan grid can be reduced afterwards by removing 
+ * vertices that are not needed by some optimal Steiner tree, see 
+ * ReduceHananGrid, or by removing vertices that cannot be part of a tree
+ * shorter than a given upper bound, see EliminateVertices. Detailed 
+ * explanations of each of Instance's members and methods are found in 
+ * the declarations below.
  *
  *
  * Instance assumes, but does not check, that:
@@ -38,6 +44,7 @@
 #include <stdlib.h>
 #include <vector>
 #include <set>
+#include <climits>
 
 #include "vertex.hpp"
 #include "util.hpp"
@@ -51,12 +58,17 @@ class Instance {
     private:
         int _n_terminals;       // Number of given terminals.
         int _n_vertices;        // Number of vertices in the Hanan grid 
-                                // generated by the terminals.
+                                // generated by the terminals (after
+                                // reducing it, if this was done).
+        int _n_hanan_vertices;  // Number of vertices in the full Hanan
+                                // grid.
 
         vector<Vertex*> _V;     // References to all vertices in 
                                 // lexicographical order.
         Vertex**** _hanan_grid; // References to all vertices, ordered 
-                                // according to the Hanan grid.
+                                // according to the Hanan grid. NULL for
+                                // vertices removed by ReduceHananGrid or
+                                // EliminateVertices.
         Vertex** _terminals;    // References to all terminals.
 
         set<int> _x_values;     // All occuring x-coordinates of terminals.
@@ -94,14 +106,89 @@ class Instance {
         /* Assign an ID to all vertices, based on their position in _V. */
         Result SetIds();
 
+        /* Choose a corner of the bounding box, say the one with minimal
+         * coordinates, and mark each vertex v (by ID) for which there are
+         * two axes a, b such that the quadrant {p : p_a <= v_a, p_b <= v_b}
+         * contains no terminal. Pushing the parts of an optimal Steiner 
+         * tree inside such quadrants onto their boundary along the 
+         * diagonal, away from the corner, does not increase its length
+         * and cannot move them into another such quadrant, so there is
+         * an optimal tree in the Hanan grid without these vertices. 
+         * Quadrants towards different corners cannot be combined like
+         * this (e.g. for the terminals (0, 1) and (1, 0) it would remove
+         * both (0, 0) and (1, 1)), so the corner removing the most 
+         * vertices is chosen. */
+        Result MarkEmptyCorners(vector<bool> &ret_removed);
+
+        /* Repeatedly remove non-terminal vertices with at most two 
+         * neighbours that are not yet marked: vertices with at most one
+         * neighbour are leaves of no optimal tree, and a vertex with two
+         * neighbours u and w is replaced by an edge between u and w if
+         * its length RectDistance(u, w) equals that of the path via the
+         * vertex. */
+        Result RemoveLowDegreeVertices(vector<bool> &removed);
+
+        /* Delete all vertices marked (by ID) in removed, and remove them
+         * from _V and _hanan_grid. The IDs of the other vertices are not
+         * changed. */
+        Result DeleteVertices(const vector<bool> &removed);
+
+        /* Compute, for every vertex (by ID), the distance ret_dist to its
+         * nearest terminal ret_base in the (reduced) Hanan grid, and the 
+         * distance ret_snd_dist to the nearest terminal other than 
+         * ret_base, by a Dijkstra search from all terminals at once in
+         * which each vertex is reached from at most two terminals. 
+         * Distances of unreachable vertices are INT_MAX. */
+        Result TwoNearestTerminals(vector<int> &ret_base, 
+                                   vector<int> &ret_dist,
+                                   vector<int> &ret_snd_dist) const;
+
     public:
         /* Constructor / Destructor. */
         Instance(int n, int **term_locs);
         ~Instance();
 
+        /* Remove vertices of the Hanan grid that are not needed by some 
+         * optimal Steiner tree, see MarkEmptyCorners and 
+         * RemoveLowDegreeVertices, and reassign the IDs of the remaining 
+         * vertices. This should be called before any labels are created.
+         * Return the number of removed vertices in ret_n_removed. */
+        Result ReduceHananGrid(int &ret_n_removed);
+
+        /* Remove every non-terminal vertex v that is in no Steiner tree
+         * of length at most upper_bound, by the test of Polzin and 
+         * Vahdati Daneshmand: Let the Voronoi region of a terminal z be
+         * the set of vertices for which z is the nearest terminal, and 
+         * rad(z) the distance from z to the nearest vertex outside it. 
+         * Then every tree containing v has length at least 
+         *      d(v, z_1) + d(v, z_2) + rad_1 + ... + rad_{|R|-2},
+         * where z_1, z_2 are the two nearest terminals of v and rad_i is
+         * the i-th smallest radius. Afterwards, vertices of low degree are
+         * removed as in ReduceHananGrid. Since distances are taken in the
+         * grid itself, this test gets stronger as the grid is reduced
+         * and as the upper bound improves, so it may be repeated. IDs of 
+         * the remaining vertices are not changed, so that it may be called
+         * after objects indexed by ID have been set up, but it should be 
+         * called before any labels are created. Return the number of 
+         * removed vertices in ret_n_removed. */
+        Result EliminateVertices(int upper_bound, int &ret_n_removed);
+
+        /* Remove all non-terminal vertices marked (by ID) in removed, as
+         * well as vertices that then have low degree, see 
+         * RemoveLowDegreeVertices. IDs of the remaining vertices are not 
+         * changed. Return the number of removed vertices in 
+         * ret_n_removed. */
+        Result RemoveVertices(vector<bool> &removed, int &ret_n_removed);
+
+        /* Return one more than the largest ID of a vertex in _V. Once
+         * vertices have been removed by EliminateVertices or 
+         * RemoveVertices, IDs are no longer consecutive. */
+        int GetIdBound() const;
+
         /* Getters / Setters. */
         const int &GetNTerminals() const;
         const int &GetNVertices() const;
+        const int &GetNHananVertices() const;
         const vector<Vertex*> &GetVertices() const;
         Vertex **GetTerminals() const;
 
@@ -10,8 +10,12 @@
  * Label is a class that, for a vertex v and a bitset I,
  * keeps track of all data related to the label (v, I), i.e.
  *      - The most current tentative value l(v, I).
- *      - The value of the lower bound lb(v, I)
+ *      - The value of the lower bound lb(v, I), and whether it was 
+ *        refined, see LazyBoundPolicy in bound_computator.hpp.
  *      - Whether (v, I) is permanent (is in P).
+ *      - The label from which l(v, I) was found, see below.
+ *      - Whether (v, I) was retired, i.e. pruned after it was popped 
+ *        from N, after which the solver no longer uses it.
  *
  * Functionality of the class is limited to accessors and modifiers for the
  * data above. Detailed explanations of each of Label's members and methods
@@ -32,9 +36,13 @@
 #include <iostream>
 #include <stdlib.h>
 #include <bitset>
+#include <climits>
 
 using namespace std;
 
+/* Predecessor of labels whose value was not found from another label. */
+#define LABEL_NO_PREDECESSOR UINT_MAX
+
 /* Forward declarations. */
 class Vertex;
 class Label;
@@ -46,24 +54,40 @@ class Label {
         bitset<BITSET_SIZE> _I; // Terminal set associated with this label.
   
         int _l;                 // Tentative value for this label.
-        bool _l_set;            // Does this label have a tentative value yet?
-        
         int _lower_bound;       // Lower bound for the complement label.
-        bool _lower_bound_set;  // Has lower bound been computed yet?
+        unsigned int _index;    // Index of this label in its LabelStore.
 
+        /* Index of the label (w, J) in P from which l(v, I) was found: 
+         * a neighbour w of v with J = I for a Dijkstra-step, or w = v 
+         * and J a proper subset of I for a merge with (v, I - J). This 
+         * determines the kind of step, so no other bits are needed. */
+        unsigned int _predecessor;
+
+        int _queue_key;         // Key of this label in the priority queue,
+                                // or -1 if it is not in the queue. Only
+                                // used by queues supporting decrease-key.
+        unsigned int _queue_pos;// Position of this label in the queue.
+
+        bool _l_set;            // Does this label have a tentative value yet?
+        bool _lower_bound_set;  // Has lower bound been computed yet?
+        bool _lower_bound_refined;  // Was the lower bound refined?
         bool _in_P;             // Is this label in P?
+        bool _retired;          // Was this label retired?
 
 
     public:
-        /* Constructor. */
-        Label(Vertex *v, const bitset<BITSET_SIZE> &I);
+        /* Constructor. The index is the position of the label in 
+         * the LabelStore that created it. */
+        Label(Vertex *v, const bitset<BITSET_SIZE> &I, unsigned int index);
 
         /* Getters. */
         int GetL() const;
         int GetLowerBound() const;
         bool IsLSet() const;
         bool IsLowerBoundSet() const;
+        bool IsLowerBoundRefined() const;
         bool IsInP() const;
+        bool IsRetired() const;
 
         /* Return a reference to the vertex associated with 
          * this label. */
@@ -73,17 +97,41 @@ class Label {
          * associated with this label. */
         const bitset<BITSET_SIZE> &GetBitset() const;
 
+        /* Return the index of this label in its LabelStore. */
+        unsigned int GetIndex() const;
+
+        /* Return the index of the predecessor of this label in its 
+         * LabelStore, or LABEL_NO_PREDECESSOR if there is none. */
+        unsigned int GetPredecessor() const;
+
         /* Set a value for _l and set _l_set to true. */
         Result SetL(int l);
+
+        /* Set the index of the label from which _l was found. */
+        Result SetPredecessor(unsigned int predecessor);
         
         /* Set a value for _lower_bound and set 
          * _lower_bound_set to true. */
         Result SetLowerBound(int l);
 
+        /* Replace the lower bound by the given (larger) value and set
+         * _lower_bound_refined to true. */
+        Result RefineLowerBound(int l);
+
         /* Set _in_P to true. Return FAIL
          * if _in_P was already true. */
         Result SetInP();
 
+        /* Set _retired to true. Return FAIL if the label is in P or
+         * was already retired. */
+        Result Retire();
+
+        /* Getters / Setters for the position of this label in a
+         * priority queue supporting decrease-key. */
+        int GetQueueKey() const;
+        unsigned int GetQueuePos() const;
+        Result SetQueuePosition(int key, unsigned int pos);
+
         /* IO-functions for testing */
         void Print() const;
 };
@@ -0,0 +1,117 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * label_queue.hpp
+ *
+ *
+ * LabelQueue is an interface for the priority queue N used in the
+ * Dijkstra-Steiner algorithm. It contains labels (v, I) ordered by an
+ * integer key, which is l(v, I) + LB(v, R-I) at the time the label was
+ * pushed. Two implementations are provided:
+ *
+ *      - HeapLabelQueue: A binary heap. Since it does not support
+ *        decrease-key, pushing a label that is already in the queue adds
+ *        a second copy of it. Such stale copies are popped eventually,
+ *        and should then be ignored by the caller.
+ *
+ *      - BucketLabelQueue: A monotone bucket queue (Dial's algorithm) with
+ *        one bucket per key. Pushing a label that is already in the queue
+ *        moves it to its new bucket, so every label is in the queue at
+ *        most once. Since the keys are small non-negative integers that
+ *        are popped in (almost) monotone order, push, pop and
+ *        decrease-key take amortized constant time. Keys larger than a
+ *        given maximum key are not stored at all.
+ *
+ * Detailed explanations of the members and methods of these classes can
+ * be found below in the declarations.
+ */
+
+#ifndef LABEL_QUEUE_HPP
+#define LABEL_QUEUE_HPP
+
+#include "util.hpp"
+#include "label.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <queue>
+
+using namespace std;
+
+/* Forward declarations. */
+class Label;
+
+/* The available implementations of LabelQueue. */
+typedef enum QueueType { HEAP_QUEUE, BUCKET_QUEUE } QueueType;
+
+class LabelQueue {
+    public:
+        virtual ~LabelQueue() {}
+
+        /* Add the given label to the queue with the given key. If the
+         * label is already in the queue, its key is updated if the queue
+         * supports decrease-key, or a second copy is added otherwise. */
+        virtual Result Push(Label *l, int key) = 0;
+
+        /* Remove a label with minimum key from the queue and return a
+         * reference to it. Return NULL if the queue is empty. */
+        virtual Label *Pop() = 0;
+
+        /* Return the minimum key in the queue, or -1 if it is empty. */
+        virtual int GetMinKey() = 0;
+
+        /* Return the number of (copies of) labels in the queue. */
+        virtual uint64_t GetSize() const = 0;
+};
+
+/* Comparator for pairs of integers and labels. Simply compares
+ * the integers. */
+struct LabelValuePairComp {
+    bool operator()(const pair<int, Label*> &lhs,
+                    const pair<int, Label*> &rhs) const {
+        return lhs.first > rhs.first;
+    }
+};
+
+class HeapLabelQueue : public LabelQueue {
+    private:
+        /* This horrible line initializes a queue of pairs of integers
+         * and references to labels. */
+        priority_queue<pair<int, Label*>, vector<pair<int, Label*> >,
+                       LabelValuePairComp> _heap;
+
+    public:
+        Result Push(Label *l, int key);
+        Label *Pop();
+        int GetMinKey();
+        uint64_t GetSize() const;
+};
+
+class BucketLabelQueue : public LabelQueue {
+    private:
+        vector<vector<Label*> > _buckets;   // _buckets[k] contains all
+                                            // labels with key k.
+        int _max_key;                       // Largest key that is stored.
+        int _cursor;                        // No bucket before _cursor is
+                                            // non-empty.
+        uint64_t _size;                     // Number of labels in queue.
+
+        /* Remove the given label from the bucket it is currently in. */
+        Result RemoveFromBucket(Label *l);
+
+    public:
+        /* Constructor. Labels pushed with a key larger than max_key are
+         * not added to the queue. */
+        BucketLabelQueue(int max_key);
+
+        Result Push(Label *l, int key);
+        Label *Pop();
+        int GetMinKey();
+        uint64_t GetSize() const;
+};
+
+#endif
@@ -0,0 +1,81 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * label_store.hpp
+ *
+ *
+ * LabelStore is a class that owns the memory of all labels created
+ * during the Dijkstra-Steiner algorithm. Instead of allocating each
+ * label on its own, labels are handed out from large slabs which are
+ * all freed at once when the LabelStore is destroyed. Labels that are
+ * no longer needed can be given back to the store, in which case their
+ * memory is reused for the next label that is requested. Each label
+ * is identified by a fixed index, which allows other data structures
+ * to refer to labels using 32 bits instead of a pointer. Detailed
+ * explanations of LabelStore's members and methods can be found below
+ * in the declarations.
+ */
+
+#ifndef LABEL_STORE_HPP
+#define LABEL_STORE_HPP
+
+#include "util.hpp"
+#include "label.hpp"
+
+#include <stdlib.h>
+#include <vector>
+#include <bitset>
+
+/* Number of labels contained in a single slab (2^LABEL_SLAB_BITS). */
+#define LABEL_SLAB_BITS 16
+#define LABEL_SLAB_SIZE (1 << LABEL_SLAB_BITS)
+
+using namespace std;
+
+/* Forward declarations. */
+class Label;
+class Vertex;
+
+class LabelStore {
+    private:
+        vector<Label*> _slabs;          // References to all slabs allocated.
+        int _n_used_in_slab;            // Number of labels handed out from
+                                        // the last slab in _slabs.
+
+        vector<unsigned int> _free_labels;  // Indices of labels given back
+                                            // to the store for reuse.
+
+        long _n_labels;                 // Number of labels currently in use.
+
+        /* Allocate a new slab and append it to _slabs. */
+        Result AddSlab();
+
+    public:
+        /* Constructor / Destructor. The destructor frees all
+         * labels handed out by this store at once. */
+        LabelStore();
+        ~LabelStore();
+
+        /* Return a reference to a new label (v, I), reusing the memory
+         * of a released label if possible. */
+        Label *NewLabel(Vertex *v, const bitset<BITSET_SIZE> &I);
+
+        /* Give the given label back to the store. The label should
+         * not be referenced anywhere anymore after calling this. */
+        Result ReleaseLabel(Label *l);
+
+        /* Return a reference to the label with the given index. This is 
+         * defined here so it can be inlined in hash table lookups. */
+        Label *GetLabel(unsigned int index) const {
+            return _slabs[index >> LABEL_SLAB_BITS] + 
+                   (index & (LABEL_SLAB_SIZE - 1));
+        }
+
+        /* Return the number of labels currently in use. */
+        long GetNLabels() const;
+};
+
+#endif
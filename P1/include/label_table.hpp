@@ -0,0 +1,101 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * label_table.hpp
+ *
+ *
+ * LabelTable is a hash table that, given a vertex v and a terminal set I,
+ * finds the label (v, I) in (expected) constant time, if it exists. A
+ * single LabelTable is used for all vertices of an instance: it is keyed
+ * by the pair (id of v, I as a 64-bit mask) and uses open addressing with
+ * linear probing in one flat array. Each entry only stores the key and
+ * the index of the label in the LabelStore that created it, so that an
+ * entry occupies 16 bytes. Detailed explanations of LabelTable's members
+ * and methods can be found below in the declarations.
+ *
+ *
+ * LabelTable assumes, but does not check, that:
+ *      - All vertices whose labels are added have a unique, non-negative ID.
+ *      - No label is added twice.
+ */
+
+#ifndef LABEL_TABLE_HPP
+#define LABEL_TABLE_HPP
+
+#include "util.hpp"
+#include "label.hpp"
+#include "label_store.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <bitset>
+
+/* Maximum fraction (in percent) of occupied entries before the table
+ * is doubled in size. */
+#define LABEL_TABLE_MAX_LOAD 75
+
+/* Bounds on the initial number of entries of the table. */
+#define LABEL_TABLE_MIN_CAPACITY (1 << 10)
+#define LABEL_TABLE_MAX_INIT_CAPACITY (1 << 22)
+
+using namespace std;
+
+/* Forward declarations. */
+class Label;
+class LabelStore;
+
+/* An entry in the table. Entries with _vertex < 0 are empty. */
+struct LabelTableEntry {
+    uint64_t _mask;         // The terminal set I of the label.
+    int _vertex;            // The ID of the vertex of the label.
+    unsigned int _label;    // The index of the label in the LabelStore.
+};
+
+class LabelTable {
+    private:
+        LabelStore *_label_store;   // Store containing the labels.
+
+        LabelTableEntry *_entries;  // The table itself.
+        uint64_t _capacity;         // Number of entries (a power of 2).
+        uint64_t _n_entries;        // Number of occupied entries.
+
+        /* Return the position at which to start probing for the given key.
+         * We use the finalizer of MurmurHash3 to mix the vertex ID and
+         * the mask. */
+        uint64_t Hash(int vertex, uint64_t I) const;
+
+        /* Insert the given entry without checking the load of the table. */
+        Result InsertEntry(const LabelTableEntry &entry);
+
+        /* Double the capacity of the table and reinsert all entries. */
+        Result Grow();
+
+    public:
+        /* Constructor / Destructor. The initial capacity is chosen based on
+         * the expected number of labels, which should be provided. */
+        LabelTable(LabelStore *label_store, uint64_t expected_n_labels);
+        ~LabelTable();
+
+        /* Add the given label to the table. */
+        Result AddLabel(Label *l);
+
+        /* Remove the given label from the table. Later entries are moved
+         * back to fill the gap, so removing does not slow down lookups. 
+         * Return FAIL if the label is not in the table. */
+        Result RemoveLabel(Label *l);
+
+        /* Return a reference to the label (v, I) for the vertex with the
+         * given ID, or NULL if there is no such label in the table. */
+        Label *GetLabel(int vertex, const bitset<BITSET_SIZE> &I) const;
+
+        /* Return the number of labels in the table. */
+        uint64_t GetNLabels() const;
+
+        /* Return the size of the table in bytes. */
+        uint64_t GetMemoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * mst_engine.hpp
+ *
+ *
+ * MSTEngine is a class that computes minimum spanning trees on subsets
+ * of the terminals of an instance, given as 64-bit masks. The distances
+ * between all pairs of terminals are computed once and stored as a 
+ * matrix whose rows are padded for the SIMD kernels in simd.hpp. Prim's
+ * algorithm then keeps the terminals not yet in the tree as a mask, and 
+ * finds the next terminal with a masked minimum over the current costs.
+ *
+ * The MSTs of all terminal sets requested through GetMST are cached,
+ * including the tree itself. If C is requested and for some terminal t 
+ * not in C the MST on C u {t} is cached and has t as a leaf, then 
+ * removing t gives an MST on C, so that it need not be computed from 
+ * scratch. This is the common case, since the complements of the 
+ * terminal sets of new labels usually lose one terminal at a time. 
+ * Deriving an MST the other way around, by inserting a terminal into a
+ * cached tree, is not faster than Prim's algorithm for at most 64 
+ * terminals, so we do not do this. Detailed explanations of MSTEngine's
+ * members and methods can be found below in the declarations.
+ *
+ *
+ * MSTEngine assumes, but does not check, that:
+ *      - There are at most BITSET_SIZE terminals.
+ *      - All masks given contain only terminals of the instance.
+ */
+
+#ifndef MST_ENGINE_HPP
+#define MST_ENGINE_HPP
+
+#include "util.hpp"
+#include "simd.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_map>
+
+/* Parent of the root of a tree, and of terminals not in the tree. */
+#define MST_NO_PARENT 0xFF
+
+using namespace std;
+
+class MSTEngine {
+    private:
+        int _n_terminals;       // Number of terminals.
+        uint64_t _terminal_mask;    // Mask containing all terminals.
+        int _row_size;          // Number of entries in a row of the
+                                // distance matrix (a multiple of 
+                                // SIMD_PAD).
+        int32_t *_distances;    // The distance between terminals i and j 
+                                // is _distances[i * _row_size + j].
+
+        /* Cache of MSTs. For a terminal set C, _cache[C] is a position p
+         * such that _lengths[p] is the length of the MST on C, and 
+         * _parents[p * _n_terminals + i] is the parent of terminal i 
+         * in it. */
+        unordered_map<uint64_t, unsigned int> _cache;
+        vector<int> _lengths;
+        vector<uint8_t> _parents;
+
+        uint64_t _n_computed;   // Number of MSTs computed by Prim.
+        uint64_t _n_derived;    // Number of MSTs derived from a cached one.
+
+        /* Compute the MST on C using Prim's algorithm, and write the 
+         * parent of each terminal in it to ret_parents if it is not 
+         * NULL. Return its length. */
+        int Prim(uint64_t C, uint8_t *ret_parents) const;
+
+        /* If the MST on C u {t} is cached and t is a leaf of it, write 
+         * the MST on C obtained by removing t to ret_parents, and 
+         * return its length. Return -1 otherwise. */
+        int RemoveLeaf(uint64_t C, int t, uint8_t *ret_parents) const;
+
+    public:
+        /* Constructor / Destructor. The coordinates of the n terminals are
+         * given as padded arrays, see simd.hpp. */
+        MSTEngine(const int32_t *xs, const int32_t *ys, const int32_t *zs, 
+                  int n);
+        ~MSTEngine();
+
+        /* Return the length of an MST on C, without using or changing 
+         * the cache. */
+        int ComputeMST(uint64_t C) const;
+
+        /* Return the length of an MST on C, fetching it from the cache if
+         * possible, and deriving or computing and caching it otherwise. 
+         * If the MST on C is cached, this only reads from the cache. */
+        int GetMST(uint64_t C);
+
+        /* Return the row of the distance matrix for terminal i, which is
+         * padded as described in simd.hpp. */
+        inline const int32_t *GetDistances(int i) const {
+            return _distances + i * _row_size;
+        }
+
+        /* Getters. */
+        uint64_t GetNComputed() const;
+        uint64_t GetNDerived() const;
+};
+
+#endif
@@ -0,0 +1,91 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * nearest_terminals.hpp
+ *
+ *
+ * NearestTerminals is a class that stores, for each vertex v of an 
+ * instance, the list of all terminals ordered by their distance to v 
+ * (ties broken by index), using one byte per terminal. Given a terminal 
+ * set I, the terminal in R-I closest to v is then the first terminal in 
+ * the list of v that is not in I, which is usually found after a few 
+ * steps. The lists are either all built at once, or built for a vertex 
+ * the first time it is queried. In both cases the lists never take more
+ * than a given amount of memory: if this would be exceeded, the 
+ * remaining vertices get no list, and queries for them fail. Detailed 
+ * explanations of NearestTerminals's members and methods can be found 
+ * below in the declarations.
+ *
+ *
+ * NearestTerminals assumes, but does not check, that:
+ *      - All vertices have a unique ID between 0 and the given number of
+ *        vertices.
+ *      - There are at most BITSET_SIZE terminals.
+ */
+
+#ifndef NEAREST_TERMINALS_HPP
+#define NEAREST_TERMINALS_HPP
+
+#include "util.hpp"
+#include "simd.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+
+/* Offset of vertices for which no list was built. */
+#define NEAREST_NOT_BUILT UINT32_MAX
+
+/* Default bound on the memory used by the lists (in bytes). */
+#define NEAREST_DEFAULT_MAX_MEMORY ((uint64_t) 64 << 20)
+
+using namespace std;
+
+/* Forward declarations. */
+class Vertex;
+
+/* When the lists are built: never, all at once, or when first needed. */
+typedef enum NearestMode { 
+    NEAREST_OFF, NEAREST_EAGER, NEAREST_LAZY 
+} NearestMode;
+
+class NearestTerminals {
+    private:
+        int _n_terminals;               // Number of terminals.
+        const int32_t *_terminal_x;     // Coordinates of the terminals,
+        const int32_t *_terminal_y;     // padded as described in 
+        const int32_t *_terminal_z;     // simd.hpp (not owned).
+
+        uint64_t _max_lists;            // Maximum number of lists.
+        vector<uint32_t> _offsets;      // The list of the vertex with ID
+                                        // i starts at _lists[_offsets[i]].
+        vector<uint8_t> _lists;         // All lists built so far.
+
+        /* Build the list of v, unless the memory bound is reached. 
+         * Return the offset of the list, or NEAREST_NOT_BUILT. */
+        uint32_t BuildList(Vertex *v);
+
+    public:
+        /* Constructor. If mode is NEAREST_EAGER, the lists of all given 
+         * vertices are built right away. */
+        NearestTerminals(const int32_t *xs, const int32_t *ys, 
+                         const int32_t *zs, int n_terminals, 
+                         const vector<Vertex*> &vertices, 
+                         NearestMode mode, uint64_t max_memory);
+
+        /* Find the terminal in R-I closest to v using its list, and write
+         * its distance to v and index to ret_dist and ret_ind. Among 
+         * terminals at the same distance, the one with the smallest index
+         * is chosen. Return FAIL if v has no list, and the memory bound
+         * does not allow building it. */
+        Result GetNearest(Vertex *v, uint64_t I, int &ret_dist, 
+                          int &ret_ind);
+
+        /* Return the memory used by the lists in bytes. */
+        uint64_t GetMemoryUsage() const;
+};
+
+#endif
@@ -0,0 +1,67 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * simd.hpp
+ *
+ *
+ * Kernels that operate on contiguous arrays of terminal set masks, and on
+ * arrays of integers with one entry per terminal (such as the coordinates
+ * of the terminals, stored as a structure of arrays). Each kernel has a
+ * portable scalar implementation, as well as AVX2 and AVX-512 
+ * implementations. Which implementation is used is decided at
+ * runtime, based on what the CPU supports (using CPUID).
+ */
+
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include "util.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <climits>
+
+/* Arrays with one entry per terminal that are passed to the kernels below
+ * should have a multiple of SIMD_PAD entries, and should preferably be 
+ * aligned to SIMD_ALIGN bytes. */
+#define SIMD_PAD 16
+#define SIMD_ALIGN 64
+
+/* The instruction sets for which kernels are available. */
+typedef enum SimdLevel { SIMD_SCALAR, SIMD_AVX2, SIMD_AVX512 } SimdLevel;
+
+/* Return the instruction set used by the kernels. By default this is
+ * the best instruction set supported by the CPU. */
+SimdLevel GetSimdLevel();
+
+/* Use the given instruction set for all kernels, e.g. for benchmarking.
+ * Return FAIL if the CPU does not support it. */
+Result SetSimdLevel(SimdLevel level);
+
+/* Return a readable name for the given instruction set. */
+const char *GetSimdLevelName(SimdLevel level);
+
+/* Find all masks among masks[0], ..., masks[n-1] that have no bits in
+ * common with I, and write their positions (in increasing order) to
+ * ret_indices, which should have room for n integers. Return the number
+ * of masks found. */
+int FindDisjointMasks(const uint64_t *masks, int n, uint64_t I,
+                      int *ret_indices);
+
+/* Write the rectilinear distance between (x, y, z) and the point 
+ * (xs[i], ys[i], zs[i]) to ret_dists[i] for i = 0, ..., n - 1. The 
+ * arrays should be padded as described above. */
+void RectDistances(const int32_t *xs, const int32_t *ys, const int32_t *zs,
+                   int n, int32_t x, int32_t y, int32_t z, 
+                   int32_t *ret_dists);
+
+/* Return the minimum of values[i] over all i for which bit i of mask is 
+ * set, and write the smallest such i attaining it to ret_index. Return 
+ * INT_MAX and write -1 to ret_index if mask is empty. values should be
+ * padded as described above. */
+int32_t MaskedMin(const int32_t *values, uint64_t mask, int &ret_index);
+
+#endif
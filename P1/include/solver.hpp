@@ -19,6 +19,35 @@
  * are found in the declarations below. 
  *
  *
+ * With more than one thread, the solver processes N bucket by bucket: all
+ * labels with the minimum key are popped and moved to P first, after which
+ * the threads compute all Dijkstra- and merge-steps for these labels at 
+ * the same time, only reading the labels, the label table and the bounds.
+ * The resulting tentative values are then applied in the same order as a
+ * single thread would, and the lower bounds of the new labels are again
+ * computed by all threads. Since the lower bounds are consistent, none of
+ * the popped labels can be improved by a label with the same key, so 
+ * they may all be moved to P at once.
+ *
+ *
+ * Optionally, instances whose terminal sets all fit into memory as dense
+ * arrays over the Hanan grid are instead solved by a SweepEngine, which 
+ * performs all Dijkstra-steps of a terminal set at once, see 
+ * sweep_engine.hpp. No labels are created then.
+ *
+ *
+ * With the adaptive lower bound, the solver decides during the search 
+ * for which terminal sets the 1-tree lower bound is worth its cost, see
+ * SolveAdaptive. For a sample of the labels it computes both bounds, and
+ * counts per size of the terminal set how many labels only the 1-tree 
+ * bound prunes and how long the 1-tree bound takes. Every label it prunes
+ * saves popping that label, so using the 1-tree bound for all sets of 
+ * size at least k pays off if the time of the pops saved for these sets 
+ * exceeds the time spent computing it for them. The best k is chosen 
+ * repeatedly as more samples come in, after which the keys of the labels 
+ * in N are recomputed if k changed.
+ *
+ *
  * Solver assumes, but does not check, that:
  *      The size of the vector of vertices in the given instance does not 
  *      exceed 64^3 and contains at least 1 vertex.
@@ -50,24 +79,103 @@
 #include "instance.hpp"
 #include "label.hpp"
 #include "bound_computator.hpp"
+#include "label_store.hpp"
+#include "label_table.hpp"
+#include "label_queue.hpp"
+#include "simd.hpp"
+#include "thread_pool.hpp"
+#include "steiner_heuristic.hpp"
+#include "sweep_engine.hpp"
 
 #include <vector>
 #include <iostream>
 #include <stdlib.h>
 #include <bitset>
-#include <queue>
 #include <iterator>
 #include <cmath>
 #include <unordered_map>
+#include <functional>
+#include <chrono>
+
+/* Estimated cost of looking up a label in the label table relative to
+ * checking a label in the packed list of labels in P of a vertex. Used 
+ * by Merge to decide whether to enumerate subsets or labels. */
+#define MERGE_LOOKUP_COST 16
+
+/* Buckets with fewer labels than this are expanded by a single thread,
+ * since waking up the other threads would take longer. */
+#define PARALLEL_MIN_BATCH 64
+
+/* With the adaptive lower bound, both bounds are computed for the labels 
+ * found while expanding every ADAPTIVE_SAMPLE_RATE-th label. The bound 
+ * is chosen after ADAPTIVE_FIRST_DECISION labels have been expanded, and 
+ * again whenever this number has doubled. */
+#define ADAPTIVE_SAMPLE_RATE 16
+#define ADAPTIVE_FIRST_DECISION 4096
 
 using namespace std;
 
-/* Comparator for pairs of integers and labels. Simply compares 
- * the integers. */
-struct LabelValuePairComp {
-    bool operator()(const pair<int, Label*> &lhs, 
-                    const pair<int, Label*> &rhs) const {
-        return lhs.first > rhs.first;
+struct SolverOptions {
+    QueueType _queue_type;
+    int _n_threads;         // Values below 2 mean a single thread.
+    bool _eliminate;        // Eliminate vertices using the upper bound?
+    bool _heuristic;        // Find an upper bound using SteinerHeuristic?
+    bool _sweep;            // Use a SweepEngine if it fits into memory?
+};
+
+/* A tentative value l for the label (v, I u J), found either by the 
+ * Dijkstra-step from (w, I) to its neighbour v (in which case J is 
+ * empty), or by merging (v, I) with (v, J) in P. */
+struct LabelCandidate {
+    Vertex *_v;
+    bitset<BITSET_SIZE> _I;
+    bitset<BITSET_SIZE> _J;
+    int _l;
+    Label *_label;          // (v, I u J) if it existed when the candidate
+                            // was found, NULL otherwise.
+    Label *_source;         // The label in P that was expanded, i.e. 
+                            // (w, I) or (v, I).
+};
+
+/* An axis-parallel segment of a Steiner tree, given by the coordinates 
+ * of its ends. */
+struct TreeSegment {
+    int _x1, _y1, _z1;
+    int _x2, _y2, _z2;
+};
+
+/* Measurements of the 1-tree lower bound for the sampled labels (v, I) 
+ * with terminal sets I of a single size, see SolveAdaptive. */
+struct BoundSample {
+    long _n_labels;     // Number of labels sampled.
+    long _n_pruned;     // Number of them pruned only by the 1-tree bound.
+    double _time;       // Seconds spent computing the 1-tree bound.
+};
+
+/* Buffers used by a single thread to expand labels. */
+struct ExpansionBuffer {
+    vector<LabelCandidate> _candidates;
+    vector<int> _merge_hits;    // Positions of labels found by Merge.
+};
+
+/* Refine the lower bound of a label that was just popped from N for the 
+ * given policy, see LazyBoundPolicy. Return whether its key increased, 
+ * in which case the label should be added to N again. Other policies 
+ * never refine. */
+template <class LowerBound>
+struct BoundRefinement {
+    static inline bool Refine(BoundComputator *, Label *) { return false; }
+};
+
+template <class CheapBound, class StrongBound>
+struct BoundRefinement<LazyBoundPolicy<CheapBound, StrongBound> > {
+    static inline bool Refine(BoundComputator *bc, Label *l) {
+        if (l->IsLowerBoundRefined())
+            return false;
+        int lb = max(l->GetLowerBound(), StrongBound::Compute(bc, l));
+        bool increased = lb > l->GetLowerBound();
+        l->RefineLowerBound(lb);
+        return increased;
     }
 };
 
@@ -76,47 +184,203 @@ class Solver {
         Instance *_problem_instance;    // The underlying problem instance.
         BoundComputator *_bound_comp;   // Bound computator for this instance.
         int _global_upper_bound;        // Upper bound for this instance.
+        bool _eliminate;                // Eliminate vertices using it?
+        int _n_eliminated;              // Number of vertices eliminated.
+        bool _heuristic;                // Improve it using a heuristic?
+        bool _sweep;                    // Solve using a SweepEngine?
+        int _MST_upper_bound;           // Length of an MST on R.
+        bitset<BITSET_SIZE> _final_terminal_set;    // R - {root}.
+        LabelStore *_label_store;       // Owner of all labels created.
+        LabelTable *_label_table;       // Finds (v, I) given v and I.
 
-        /* Priority queue of lables added during the algorithm. This 
-         * horrible line initializes a queue of pairs of integers and
-         * references to labels. The integers represent the value 
-         * l(v, I) + LB(v, R-I) AT THE TIME THE PAIR IS ADDED 
-         * TO THE QUEUE. We need this implementation to deal with the 
-         * dynamic nature of these values. */
-        priority_queue<pair<int, Label*>, vector<pair<int, Label*> >,
-                       LabelValuePairComp> _N;
+        /* Priority queue of lables added during the algorithm. The
+         * keys represent the value l(v, I) + LB(v, R-I) AT THE TIME THE 
+         * LABEL IS ADDED TO THE QUEUE. Depending on the implementation,
+         * the queue may contain stale copies of labels whose value 
+         * changed, see label_queue.hpp. */
+        QueueType _queue_type;
+        LabelQueue *_N;
+        int _current_key;       // Key of the label popped last.
+
+        /* Threads used to expand labels and compute lower bounds. NULL 
+         * if only a single thread is used. */
+        int _n_threads;
+        ThreadPool *_thread_pool;
+
+        /* One expansion buffer per thread. */
+        vector<ExpansionBuffer> _buffers;
+
+        /* Labels popped from N in the current bucket, labels created 
+         * while applying their candidates, and labels whose value 
+         * changed while applying their candidates. */
+        vector<Label*> _batch;
+        vector<Label*> _new_labels;
+        vector<Label*> _updated_labels;
+
+        /* Number of labels retired, and a buffer for the labels removed
+         * from a vertex when retiring a label. */
+        long _n_retired;
+        vector<Label*> _removed_labels;
+
+        /* Measurements of the adaptive lower bound, by the size of the
+         * terminal set. */
+        vector<BoundSample> _bound_samples;
 
         /* Set a global upper bound for the current instance by
-         * computing the value of an MST on R. */
+         * computing the value of an MST on R. If _heuristic is set, 
+         * vertices are eliminated using this bound, after which the 
+         * bound is improved using SteinerHeuristic, which also gives
+         * local upper bounds U(I) for the terminal sets I of its 
+         * subtrees. */
         Result SetGlobalUpperBound();
 
+        /* Remove all vertices of the instance that cannot be part of a 
+         * tree of length at most the global upper bound, see 
+         * Instance::EliminateVertices, and if the dual ascent lower bound
+         * is used also vertices and edges that fail the reduced cost test
+         * of DualAscent::EliminateVertices. Should be called again whenever
+         * the global upper bound improves, as long as no labels have been
+         * created. Does nothing unless _eliminate is set. */
+        Result EliminateVertices();
+
+        /* Return whether a label (v, I) with value l would be pruned
+         * right away according to Lemma 14 and 15 in Hougardy et al.
+         * This allows us to check labels before creating them. */
+        bool IsPrunable(const bitset<BITSET_SIZE> &I, int l);
+
+        /* Create the label (v, I) with value l, and add it to the labels
+         * of v as well as to the label table. */
+        Label *NewLabel(Vertex *v, const bitset<BITSET_SIZE> &I, int l);
+
         /* Add a label to the priority queue _N and
         *  compute the lower bound for the label 
-        *  if this hasn't happened before. */
+        *  if this hasn't happened before, using the given lower 
+        *  bound policy (see bound_computator.hpp). The methods 
+        *  below that add labels to N take the same policy. */
+        template <class LowerBound>
         Result AddLabelToN(Label *l);
 
         /* Add (s, {s}) to N for each terminal s unequal to 
          * the root. */
+        template <class LowerBound>
         Result SetInitialN();
 
         /* Add (s, emptyset) for all vertices s with 
          * l(s, emptyset) = 0 and put these labels in P. */
         Result SetInitialLabels();
 
-        /* Consider for the given label (v, I) all neighbours
-         * (w, I) and perform the Dijkstra-step if needed. */   
-        Result ConsiderNeighbours(Label *l);
+        /* Consider for the given label (v, I) all neighbours (w, I)
+         * and add a candidate to buf for each Dijkstra-step that could 
+         * improve l(w, I). Does not change any labels. */   
+        Result ConsiderNeighbours(Label *l, ExpansionBuffer &buf);
+
+        /* Add a candidate to buf for each merge of the given label 
+         * (v, I) with a label (v, J) in P that could improve l(v, I u J).
+         * Depending on which is cheaper, either the labels of v in P or 
+         * the subsets of R - I are enumerated to find the labels to 
+         * merge with. Does not change any labels. */
+        Result Merge(Label *l, ExpansionBuffer &buf);
+
+        /* Apply the given candidate, creating or updating (v, I u J) as 
+         * needed. Labels are added to N right away if new_labels is NULL.
+         * Otherwise, created labels are appended to new_labels and 
+         * updated labels to _updated_labels, and should be added to N 
+         * by the caller. Return FAIL if the candidate was discarded. */
+        template <class LowerBound>
+        Result ApplyCandidate(const LabelCandidate &c, 
+                              vector<Label*> *new_labels);
 
-        /* Perform the merge-step for the given label. */
-        Result Merge(Label *v_label);
+        /* Split 0, ..., n - 1 into consecutive ranges, one for each 
+         * thread, and call task(t, begin, end) for the range of thread
+         * t. If n is small, a single thread handles all of it. */
+        Result RunInParallel(int n, 
+                             const function<void(int, int, int)> &task);
+
+        /* Retire a label that was pruned after it was popped from N: 
+         * remove it from the label table and, once enough labels of its
+         * vertex are retired, from the labels of the vertex, giving them
+         * back to the label store. No candidates or labels in P refer to
+         * such a label. This is only done if N supports decrease-key, 
+         * since N may otherwise still contain copies of the label. 
+         * Return FAIL if the label was not retired. */
+        Result RetireLabel(Label *l);
+
+        /* Pop the next label from N and, unless it is pruned, move it to
+         * P. If the lower bound policy is lazy and the key of the label 
+         * increases when its bound is refined, it is added to N again 
+         * instead. Return NULL if no label was moved to P, and set done if
+         * the label moved to P is (root, R - {root}). */
+        template <class LowerBound>
+        Label *PopPermanentLabel(bool &done);
+
+        /* Run the algorithm using a single thread. */
+        template <class LowerBound>
+        Result SolveSequential();
+
+        /* Run the algorithm processing N bucket by bucket using all 
+         * threads, see the description at the top of this file. */
+        template <class LowerBound>
+        Result SolveParallel();
+
+        /* Set the lower bounds of the labels in _new_labels for the 
+         * adaptive lower bound, computing both the bounding box and the 
+         * 1-tree lower bound for each of them and adding the results to 
+         * _bound_samples. */
+        Result SampleLowerBounds();
+
+        /* Choose the smallest size of the terminal sets for which the 
+         * adaptive lower bound uses the 1-tree lower bound, given the 
+         * number of labels expanded and the seconds spent so far, and 
+         * write the decision to cerr. If it changes, the lower bounds and
+         * keys of the labels in N are recomputed. */
+        Result SelectLowerBound(long n_expanded, double seconds);
+
+        /* Run the algorithm using a single thread and the adaptive lower
+         * bound, see the description at the top of this file. */
+        Result SolveAdaptive();
+
+        /* Fill N and run the algorithm using the given lower bound 
+         * policy, with one or more threads. */
+        template <class LowerBound>
+        Result Solve();
 
     public:
-        /* Constructor / Destructor. */
-        Solver(Instance *problem_instance, BoundComputator *bound_comp);
+        /* Constructor / Destructor. The SolverOptions struct is freed
+         * by the constructor. If it is NULL, a bucket queue and a single
+         * thread are used. */
+        Solver(Instance *problem_instance, BoundComputator *bound_comp,
+               SolverOptions *opts);
+        ~Solver();
 
         /* Attempt to solve the current instance. Return SUCCESS and
-         * place solution in ret if successful, return FAIL otherwise. */
+         * place solution in ret if successful, return FAIL otherwise. If
+         * _sweep is set and the arrays of a SweepEngine take at most 
+         * SWEEP_DEFAULT_MAX_MEMORY bytes, the instance is solved by the 
+         * SweepEngine instead of by labels. */
         Result SolveCurrentInstance(int &ret);
+
+        /* Find an optimal tree after SolveCurrentInstance succeeded, by
+         * following the predecessors of the labels starting from 
+         * (root, R - {root}). Return its edges as axis-parallel segments
+         * in ret_segments, where an edge of the reduced grid that is not
+         * axis-parallel is split into segments along the x-, y- and 
+         * z-axis (in this order), and its Steiner points (vertices that 
+         * are not terminals and have at least three neighbours in the 
+         * tree) in ret_steiner_points. Return FAIL if no solution was 
+         * found, or if it was found by a SweepEngine. */
+        Result GetSolutionTree(vector<TreeSegment> &ret_segments,
+                               vector<Vertex*> &ret_steiner_points);
+
+        /* Statistics: the global upper bound used, the length of an MST
+         * on R, the number of vertices eliminated, the number of labels
+         * in use, the number of labels retired and the size of the label
+         * table in bytes. */
+        int GetGlobalUpperBound() const;
+        int GetMSTUpperBound() const;
+        int GetNEliminatedVertices() const;
+        long GetNLabels() const;
+        long GetNRetiredLabels() const;
+        uint64_t GetLabelTableMemoryUsage() const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * steiner_heuristic.hpp
+ *
+ *
+ * SteinerHeuristic is a class that, given an Instance, quickly finds a
+ * (usually short, but not necessarily optimal) Steiner tree for its
+ * terminals using the batched iterated 1-Steiner heuristic of Kahng and
+ * Robins. Starting from the terminals, it repeatedly:
+ *      - Computes for every vertex of the (reduced) Hanan grid the gain
+ *        MST(P) - MST(P u {c}) of adding it to the current set of points
+ *        P. Since the MST on P u {c} only uses edges of the MST on P and
+ *        edges at c, this takes O(|P| log |P|) time per vertex.
+ *      - Adds the vertices with positive gain to P in order of decreasing
+ *        gain, as long as their gain is still positive w.r.t. the points
+ *        added before them.
+ *      - Removes Steiner points with at most two neighbours in the MST on
+ *        P, which does not make the MST longer.
+ * until no more vertices are added. The result is the MST on the final
+ * points, rooted at the root terminal. Its length is an upper bound for
+ * the instance, and each of its subtrees gives a local upper bound for
+ * the terminals it contains. Detailed explanations of SteinerHeuristic's
+ * members and methods can be found below in the declarations.
+ *
+ *
+ * SteinerHeuristic makes the same assumptions on the given instance
+ * Solver does.
+ */
+
+#ifndef STEINER_HEURISTIC_HPP
+#define STEINER_HEURISTIC_HPP
+
+#include "util.hpp"
+#include "vertex.hpp"
+#include "instance.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/* Maximum number of rounds of the heuristic. In practice it stops after
+ * a few rounds. */
+#define HEURISTIC_MAX_ROUNDS 16
+
+/* Forward declarations. */
+class Vertex;
+class Instance;
+
+/* An edge of the MST on the current points, given by the positions of
+ * its ends in _points. */
+struct HeuristicEdge {
+    int _length;
+    int _a;
+    int _b;
+};
+
+class SteinerHeuristic {
+    private:
+        Instance *_problem_instance;    // The underlying problem instance.
+        int _n_terminals;               // Number of terminals.
+
+        /* The current points P: the terminals (at the position of their
+         * index) followed by the Steiner points that were added. */
+        vector<Vertex*> _points;
+
+        /* The MST on _points: the edges in increasing order of length,
+         * its length and the parent of each point when rooted at the
+         * root terminal. */
+        vector<HeuristicEdge> _edges;
+        int _length;
+        vector<int> _parents;
+
+        /* For each point, the terminals in its subtree and the length of
+         * its subtree, see ComputeSubtrees. */
+        vector<uint64_t> _subtree_masks;
+        vector<int> _subtree_lengths;
+
+        /* Compute the MST on _points using Prim's algorithm and fill
+         * _edges, _length and _parents. */
+        Result ComputeMST();
+
+        /* Return MST(P) - MST(P u {c}), using Kruskal's algorithm on the
+         * edges of the MST on P and the edges between c and P. */
+        int Gain(Vertex *c) const;
+
+        /* Remove Steiner points with at most two neighbours in the MST
+         * until there are none. Return the number of removed points. */
+        int RemoveSteinerPoints();
+
+        /* Fill _subtree_masks and _subtree_lengths. */
+        Result ComputeSubtrees();
+
+    public:
+        /* Constructor. Does not run the heuristic yet. */
+        SteinerHeuristic(Instance *problem_instance);
+
+        /* Run the heuristic, using the vertices of the instance as
+         * candidate Steiner points. */
+        Result Run();
+
+        /* Return the length of the tree found. */
+        int GetLength() const;
+
+        /* Return the number of points in the tree found, the vertex of
+         * point i and the position of its parent (-1 for the root). The
+         * first points are the terminals, in the order of the instance. */
+        int GetNPoints() const;
+        Vertex *GetPoint(int i) const;
+        int GetParent(int i) const;
+
+        /* Return the mask of the terminals in the subtree of point i and
+         * the length of the subtree (not including the edge to its
+         * parent). */
+        uint64_t GetSubtreeMask(int i) const;
+        int GetSubtreeLength(int i) const;
+};
+
+#endif
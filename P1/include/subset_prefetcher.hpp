@@ -0,0 +1,104 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * subset_prefetcher.hpp
+ *
+ *
+ * SubsetPrefetcher is a class that computes values that BoundComputator
+ * stores per terminal set I (d(I, R-I) and MST(R-I)) on a worker thread,
+ * for terminal sets that the search will probably need soon. The thread
+ * that created it submits terminal sets, and later collects the results
+ * and stores them itself. The worker therefore never touches the subset
+ * table, and the search itself stays single-threaded.
+ *
+ * Submitted terminal sets are handed to the worker in batches, and the
+ * results are only collected once an atomic flag says there are any, so
+ * the submitting thread rarely needs to lock. Terminal sets that are
+ * submitted again before their results are collected are ignored. If the
+ * worker falls behind too far, new batches are dropped, since the values
+ * are computed when they are needed anyways. Detailed explanations of
+ * SubsetPrefetcher's members and methods can be found below in the
+ * declarations.
+ *
+ *
+ * SubsetPrefetcher assumes, but does not check, that:
+ *      - Submit and Collect are only called from the thread that created
+ *        the prefetcher.
+ *      - The given function may be called from the worker thread while
+ *        the creating thread does other work.
+ */
+
+#ifndef SUBSET_PREFETCHER_HPP
+#define SUBSET_PREFETCHER_HPP
+
+#include "util.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+/* Number of terminal sets handed to the worker at once. */
+#define PREFETCH_BATCH 64
+
+/* Maximum number of terminal sets waiting for the worker. */
+#define PREFETCH_MAX_QUEUE (1 << 16)
+
+using namespace std;
+
+/* The values computed for a terminal set I. */
+struct PrefetchedSubset {
+    uint64_t _mask;         // The terminal set I.
+    int32_t _distance;      // d(I, R-I).
+    int32_t _distance_ind;  // Terminal in R-I minimizing d(i, I).
+    int32_t _MST;           // MST(R-I), or SUBSET_NOT_COMPUTED.
+};
+
+class SubsetPrefetcher {
+    private:
+        /* Fills in the values of a PrefetchedSubset given its mask. */
+        function<void(PrefetchedSubset&)> _compute;
+        thread _worker;
+
+        /* Terminal sets submitted but not yet collected, and those not
+         * yet handed to the worker. Only used by the creating thread. */
+        unordered_set<uint64_t> _submitted;
+        vector<uint64_t> _batch;
+
+        mutex _mutex;                   // Guards the members below.
+        condition_variable _work_cv;    // Signals new work or _stop.
+        vector<uint64_t> _queue;        // Terminal sets for the worker.
+        vector<PrefetchedSubset> _results;  // Values not yet collected.
+        bool _stop;                     // Set when the prefetcher is
+                                        // destroyed.
+        atomic<bool> _has_results;      // Is _results non-empty?
+
+        /* Main loop of the worker. */
+        void WorkerLoop();
+
+        /* Hand the current batch to the worker. */
+        Result Flush();
+
+    public:
+        /* Constructor / Destructor. Starts the worker thread, and stops
+         * and joins it on destruction. */
+        SubsetPrefetcher(const function<void(PrefetchedSubset&)> &compute);
+        ~SubsetPrefetcher();
+
+        /* Ask the worker to compute the values for I. */
+        Result Submit(uint64_t I);
+
+        /* Append the values computed since the last call to ret_results.
+         * Return FAIL if there were none. */
+        Result Collect(vector<PrefetchedSubset> &ret_results);
+};
+
+#endif
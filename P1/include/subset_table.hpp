@@ -0,0 +1,134 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * subset_table.hpp
+ *
+ *
+ * SubsetTable is a hash table that stores all values BoundComputator 
+ * keeps for a terminal set I in a single record: the local upper bound
+ * U(I) with the terminal set S(I) used to find it, the distance d(I, R-I)
+ * with the terminal attaining it, and MST(R-I). It is keyed by I as a 
+ * 64-bit mask and uses open addressing with linear probing in one flat
+ * array, so that finding all values for I takes a single probe sequence.
+ * Records are 32 bytes and the array is aligned to a cache line, so that
+ * each record lies within one cache line. 
+ *
+ * For instances with few terminals, SubsetTable can instead be dense: it
+ * then holds a record for every terminal set I not containing the root
+ * (terminal 0), at position I / 2, so that finding a record needs no 
+ * hashing or probing at all. A dense table for n terminals takes 
+ * 2^(n-1) * 32 bytes, e.g. 16MB for 20 terminals. Detailed explanations 
+ * of SubsetTable's members and methods can be found below in the 
+ * declarations.
+ *
+ *
+ * SubsetTable assumes, but does not check, that:
+ *      - The mask SUBSET_EMPTY_KEY, i.e. the set of all 64 terminals
+ *        including the root, is never used as a key.
+ *      - If the table is dense, all keys are terminal sets of the 
+ *        instance not containing the root.
+ */
+
+#ifndef SUBSET_TABLE_HPP
+#define SUBSET_TABLE_HPP
+
+#include "util.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <climits>
+
+/* Maximum fraction (in percent) of occupied records before the table
+ * is doubled in size. */
+#define SUBSET_TABLE_MAX_LOAD 75
+
+/* Initial number of records of the table. */
+#define SUBSET_TABLE_MIN_CAPACITY (1 << 12)
+
+/* Default bound on the size of a dense table in bytes. With 32 byte 
+ * records this allows dense tables for up to 24 terminals. */
+#define SUBSET_DENSE_DEFAULT_MAX_MEMORY ((uint64_t) 256 << 20)
+
+/* Key of empty records. */
+#define SUBSET_EMPTY_KEY (~(uint64_t) 0)
+
+/* Values of fields that are not set. */
+#define SUBSET_NO_UPPER_BOUND INT_MAX
+#define SUBSET_NOT_COMPUTED -1
+
+/* The ways the table can be organized: hashed, dense with values computed
+ * when they are first needed, or dense with the values that do not depend
+ * on the search computed for all terminal sets in advance. See 
+ * BoundComputator::PrecomputeSubsetTable. */
+typedef enum SubsetMode { 
+    SUBSET_HASHED, SUBSET_DENSE_LAZY, SUBSET_DENSE_EAGER 
+} SubsetMode;
+
+/* A record of the table. */
+struct SubsetRecord {
+    uint64_t _mask;         // The terminal set I.
+    uint64_t _S;            // S(I), if U(I) is set.
+    int32_t _U;             // U(I), or SUBSET_NO_UPPER_BOUND.
+    int32_t _distance;      // d(I, R-I), or SUBSET_NOT_COMPUTED.
+    int32_t _distance_ind;  // Terminal in R-I minimizing d(i, I).
+    int32_t _MST;           // MST(R-I), or SUBSET_NOT_COMPUTED.
+};
+
+class SubsetTable {
+    private:
+        SubsetRecord *_records;     // The table itself.
+        uint64_t _capacity;         // Number of records (a power of 2).
+        uint64_t _n_records;        // Number of occupied records.
+        bool _dense;                // Is there a record for every I?
+
+        /* Return the position at which to start probing for I, using 
+         * the finalizer of MurmurHash3. */
+        uint64_t Hash(uint64_t I) const;
+
+        /* Allocate an empty array of records of the given size. */
+        SubsetRecord *AllocateRecords(uint64_t capacity) const;
+
+        /* Make r the record for I, with no values set. */
+        void ClearRecord(SubsetRecord &r, uint64_t I) const;
+
+        /* Double the capacity of the table and reinsert all records. */
+        Result Grow();
+
+    public:
+        /* Constructor / Destructor. If dense is set, the table contains
+         * a record for every terminal set of an instance with the given
+         * number of terminals. Otherwise n_terminals is ignored. */
+        SubsetTable(bool dense, int n_terminals);
+        ~SubsetTable();
+
+        /* Return the size of a dense table for the given number of 
+         * terminals in bytes. */
+        static uint64_t DenseMemoryUsage(int n_terminals);
+
+        /* Return a reference to the record for I, or NULL if there is no
+         * such record (which never happens if the table is dense). Only 
+         * reads from the table. */
+        SubsetRecord *Find(uint64_t I) const;
+
+        /* Return a reference to the record for I, inserting a record 
+         * with no values set if there is no such record. If the table is
+         * not dense, this may move all records, so references returned 
+         * earlier become invalid. */
+        SubsetRecord *FindOrInsert(uint64_t I);
+
+        /* Statistics: the number of records, the number of records the
+         * table has room for, the average and maximum number of records
+         * probed to find an existing record, and the size of the table 
+         * in bytes. */
+        uint64_t GetNRecords() const;
+        uint64_t GetCapacity() const;
+        double GetAverageProbeLength() const;
+        uint64_t GetMaxProbeLength() const;
+        uint64_t GetMemoryUsage() const;
+        bool IsDense() const;
+};
+
+#endif
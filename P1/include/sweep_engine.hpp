@@ -0,0 +1,108 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * sweep_engine.hpp
+ *
+ *
+ * SweepEngine is a class that, given an Instance, computes the length of
+ * a shortest Steiner tree for its terminals by propagating the values
+ * l(v, I) of a whole terminal set I at once, instead of label by label.
+ * The full Hanan grid of the terminals contains an optimal tree and is a
+ * complete rectilinear grid, so the Dijkstra-steps for I together give
+ *      l(v, I) = min_w ( m(w, I) + d(v, w) ),
+ * where m(w, I) is the best value found for (w, I) by merging (or 0 for
+ * w = s if I = {s}), and d is the L1 distance. This is a distance
+ * transform, which separates into one transform per axis, each of which
+ * is a forward and a backward sweep along every line of the grid:
+ *      a[i] = min(a[i], a[i - 1] + c[i] - c[i - 1])     (forward)
+ *      a[i] = min(a[i], a[i + 1] + c[i + 1] - c[i])     (backward)
+ * for the coordinates c along the axis. The values of all vertices for I
+ * are stored as one dense |X| x |Y| x |Z| array.
+ *
+ * The terminal sets I not containing the root are handled in increasing
+ * order of their mask, so that all proper subsets of I come before I. For
+ * each I, first the merge-step computes m(w, I) from the arrays of J and
+ * I - J for all splits of I, after which the sweeps perform all
+ * Dijkstra-steps. The array of I is thus final before it is used by any
+ * merge. The length of the tree is l(root, R - {root}). This is the
+ * algorithm of Dreyfus and Wagner, and takes time in the order of 3^|R|
+ * times the size of the grid without any pruning, and memory for 2^|R|
+ * arrays, so it is only meant for instances with few terminals. Detailed
+ * explanations of SweepEngine's members and methods can be found below
+ * in the declarations.
+ *
+ *
+ * SweepEngine makes the same assumptions on the given instance Solver
+ * does, and only uses the coordinates of its terminals.
+ */
+
+#ifndef SWEEP_ENGINE_HPP
+#define SWEEP_ENGINE_HPP
+
+#include "util.hpp"
+#include "vertex.hpp"
+#include "instance.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <climits>
+
+/* Default bound on the memory used for the arrays in bytes. */
+#define SWEEP_DEFAULT_MAX_MEMORY ((uint64_t) 1 << 30)
+
+/* Value of vertices that are not reached yet. Adding two of these or
+ * adding a distance does not overflow. */
+#define SWEEP_INFINITY (INT_MAX / 2)
+
+using namespace std;
+
+/* Forward declarations. */
+class Vertex;
+class Instance;
+
+class SweepEngine {
+    private:
+        Instance *_problem_instance;    // The underlying problem instance.
+        int _n_terminals;               // Number of terminals.
+
+        /* The distinct coordinates of the terminals along each axis in
+         * increasing order, and the number of vertices of the grid. The
+         * vertex with positions (i, j, k) along the axes is at position
+         * (i * |Y| + j) * |Z| + k of an array. */
+        vector<int> _coords[3];
+        int _n_cells;
+
+        /* Position of each terminal in an array. */
+        vector<int> _terminal_cells;
+
+        /* The arrays of all terminal sets I not containing the root, the
+         * one of I at position (I / 2) * _n_cells. */
+        vector<int32_t> _values;
+
+        int _length;                    // The length found by Run.
+
+        /* Perform all Dijkstra-steps for the given array by sweeping
+         * along each axis. */
+        Result Sweep(int32_t *values) const;
+
+    public:
+        /* Constructor. Sets up the grid, but does not allocate the arrays
+         * or run the algorithm yet. */
+        SweepEngine(Instance *problem_instance);
+
+        /* Return the memory the arrays of the given instance take in
+         * bytes. */
+        static uint64_t MemoryUsage(Instance *problem_instance);
+
+        /* Run the algorithm described above. */
+        Result Run();
+
+        /* Return the length of a shortest Steiner tree, after Run. */
+        int GetLength() const;
+};
+
+#endif
@@ -0,0 +1,71 @@
+/*  Lucas Slot (lfh.slot@gmail.com)
+ *  Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * thread_pool.hpp
+ *
+ *
+ * ThreadPool is a class that keeps a fixed number of threads alive and 
+ * lets all of them run the same task, after which the caller waits until
+ * every thread has finished. The calling thread takes part in the work
+ * itself, so a pool of n threads only starts n - 1 new ones. The pool is
+ * meant for many short rounds of work (one per bucket of the priority 
+ * queue), so threads are started only once and wait on a condition
+ * variable in between rounds. Detailed explanations of ThreadPool's 
+ * members and methods can be found below in the declarations.
+ *
+ *
+ * ThreadPool assumes, but does not check, that:
+ *      - Run is only called from the thread that created the pool.
+ */
+
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "util.hpp"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+using namespace std;
+
+class ThreadPool {
+    private:
+        int _n_threads;                 // Number of threads, including
+                                        // the calling thread.
+        vector<thread> _workers;        // Threads 1, ..., n - 1.
+
+        mutex _mutex;                   // Guards all members below.
+        condition_variable _start_cv;   // Signals a new round or _stop.
+        condition_variable _done_cv;    // Signals the end of a round.
+        const function<void(int)> *_task;   // Task of the current round.
+        uint64_t _round;                // Number of rounds started.
+        int _n_busy;                    // Workers still running the task.
+        bool _stop;                     // Set when the pool is destroyed.
+
+        /* Main loop of the worker with the given thread number. */
+        void WorkerLoop(int thread_id);
+
+    public:
+        /* Constructor / Destructor. Starts n_threads - 1 worker threads,
+         * and stops and joins them on destruction. */
+        ThreadPool(int n_threads);
+        ~ThreadPool();
+
+        /* Call task(t) for t = 0, ..., n - 1, each on a different 
+         * thread (task(0) runs on the calling thread), and return once
+         * all calls have returned. */
+        Result Run(const function<void(int)> &task);
+
+        /* Return the number of threads, including the calling thread. */
+        int GetNThreads() const;
+};
+
+#endif
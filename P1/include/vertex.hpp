@@ -10,10 +10,10 @@
  * Vertex is a class that, given three integers x, y, z represents
  * a vertex in R^3 at location (x,y,z). A Vertex can be assigned
  * neighbours (which are references to other vertices) and labels,
- * which it will save in vectors. Additionaly, a Vertex v is capable
- * of finding in constant time any label (v, I) assigned to it, given
- * I, using a hash table. Detailed explanations of Vertex's members
- * and methods can be found below in the declarations.
+ * which it will save in vectors. Finding a label (v, I) given I is 
+ * done by the LabelTable of the solver, which uses the ID of v. 
+ * Detailed explanations of Vertex's members and methods can be 
+ * found below in the declarations.
  */ 
 
 #ifndef VERTEX_HPP
@@ -24,12 +24,17 @@
 
 #include <iostream>
 #include <stdlib.h>
+#include <stdint.h>
 #include <vector>
 #include <bitset>
-#include <unordered_map>
 #include <iterator>
 
 
+/* The labels of a vertex are compacted once at least 1 / this fraction of
+ * them are retired, see RetireLabel. Compacting takes time linear in the 
+ * number of labels, so this is constant time per retired label. */
+#define VERTEX_COMPACT_FRACTION 8
+
 using namespace std;
 
 /* Forward declaration */
@@ -47,12 +52,16 @@ class Vertex {
 
         int _n_labels;                  // Number of lables with l < infty.
         vector<Label*> _labels;         // References to labels with l < infty.
+        int _n_retired;                 // Number of retired labels in _labels.
 
-        bool _is_root;                  // Is this the root vertex?
+        /* Terminal sets J and values l(v, J) of all labels (v, J) in P
+         * with J non-empty, in the order in which they were added to P. 
+         * They are stored contiguously so that Merge can scan them 
+         * quickly. */
+        vector<uint64_t> _P_masks;
+        vector<int> _P_values;
 
-        /* Hash table containing the index of a label in _labels, 
-        * if it is indeed in _labels. */
-        unordered_map<bitset<BITSET_SIZE>, int> _label_hash;   
+        bool _is_root;                  // Is this the root vertex?
 
 
     public:
@@ -64,10 +73,30 @@ class Vertex {
          * the number of neighbours. */
         Result AddNeighbour(Vertex* w);
 
-        /* Add given reference to label to _labels and add its index 
-         * to the hash table for labels. */
+        /* Remove the given vertex from the neighbours of this vertex. 
+         * Return FAIL if it is not a neighbour. */
+        Result RemoveNeighbour(Vertex* w);
+
+        /* Replace the neighbour old_w of this vertex by w. Return FAIL
+         * if old_w is not a neighbour. */
+        Result ReplaceNeighbour(Vertex* old_w, Vertex* w);
+
+        /* Return whether the given vertex is a neighbour of this vertex. */
+        bool HasNeighbour(Vertex* w) const;
+
+        /* Add given reference to label to _labels. */
         Result AddLabel(Label *l);
 
+        /* Count a label of this vertex that was just retired. Once at 
+         * least 1 / VERTEX_COMPACT_FRACTION of the labels in _labels are
+         * retired, remove all retired labels from _labels, keeping the
+         * order of the others, and append them to ret_removed. */
+        Result RetireLabel(vector<Label*> &ret_removed);
+
+        /* Append the terminal set and value of the given label, which 
+         * should have just been added to P, to _P_masks and _P_values. */
+        Result AddPermanentLabel(Label *l);
+
         /* Return whether the vertex is located at given coordinates. */
         bool HasCoords(int x, int y, int z) const;
 
@@ -79,10 +108,13 @@ class Vertex {
         /* Return ID of this vertex. Print a warning if it was unset (<0). */
         const int& GetId() const;
 
-        /* Set an ID for this vertex, which must be positive. Return FAIL
-         * if an ID was already set. */
+        /* Set an ID for this vertex, which must be non-negative. Return 
+         * FAIL if an ID was already set. */
         Result SetId(int id);
 
+        /* Unset the ID of this vertex, so that a new one can be set. */
+        Result ResetId();
+
         /* Return whether this vertex is the root. */
         bool IsRoot() const;
 
@@ -98,11 +130,11 @@ class Vertex {
         /* Return a reference to the labels corresponding to this vertex. */
         const vector<Label*> &GetLabels() const;
 
-        /* Find the label corresponding to the given bitset in the hash
-         * table and return a reference to it. Return NULL if the label 
-         * cannot be found. */
-        Label* GetLabelByBitset(const bitset<BITSET_SIZE> &I) const;
-        
+        /* Return references to the terminal sets and values of the 
+         * non-empty labels of this vertex that are in P. */
+        const vector<uint64_t> &GetPermanentMasks() const;
+        const vector<int> &GetPermanentValues() const;
+
         /* Operator overload that returns whether the IDs of the given
          * vertices are identical. */
         bool operator==(const Vertex& other);
@@ -2,6 +2,7 @@
 #include "util.hpp"
 #include "instance.hpp"
 #include "solver.hpp"
+#include "simd.hpp"
 
 #include <stdlib.h>
 #include <string>
@@ -19,7 +20,16 @@ int main(int argc, char* argv[]) {
 
     /* Check if an argument was given. */
     if (argc < 2) {
-        cout << "Usage: ./bin/main filename [ALL / OT / BB / NONE]\n";
+        cout << "Usage: ./bin/main filename " <<
+                "[ALL / AUTO / OT / BB / DA / NONE] " <<
+                "[--queue heap / bucket] [--simd scalar / avx2 / avx512] " <<
+                "[--threads n] [--nearest off / eager / lazy] " <<
+                "[--nearest-memory megabytes] " <<
+                "[--dense off / lazy / eager] [--dense-memory megabytes] " <<
+                "[--reduce on / off] [--lazy on / off] " <<
+                "[--prefetch on / off] [--sweep on / off] " <<
+                "[--eliminate on / off] " <<
+                "[--heuristic on / off] [--tree] [--stats]\n";
         exit(1);
     }
 
@@ -29,34 +39,244 @@ int main(int argc, char* argv[]) {
         exit(1);
     }
 
+    /* Reduce the Hanan grid unless told otherwise. */
+    bool reduce = true;
+
+    /* Eliminate vertices using the upper bound if told so, and by default
+     * only with the dual ascent lower bound, see Solver::EliminateVertices.
+     * Without it, the test hardly ever removes any vertices. */
+    bool eliminate_given = false;
+
+    /* Print an optimal tree and statistics after the solution if 
+     * asked to. */
+    bool tree = false;
+    bool stats = false;
+
     /* Make a BoundComputator. */
     BoundOptions *opts = (BoundOptions*) calloc(1, sizeof(BoundOptions));
     opts->_use_BB_lower_bound = true;
     opts->_use_onetree_lower_bound = false;
+    opts->_nearest_mode = NEAREST_OFF;
+    opts->_subset_mode = SUBSET_HASHED;
+    opts->_lazy_lower_bound = false;
+    opts->_adaptive_lower_bound = false;
+    opts->_prefetch_subsets = false;
 
-    /* Read options for lower bounds */
-    if (argc > 2) {
-        string bound_arg(argv[2]);
-        if (bound_arg.compare("ALL") == 0) {
+    SolverOptions *solver_opts = 
+        (SolverOptions*) calloc(1, sizeof(SolverOptions));
+    solver_opts->_queue_type = BUCKET_QUEUE;
+    solver_opts->_n_threads = 1;
+    solver_opts->_eliminate = false;
+    solver_opts->_heuristic = true;
+    solver_opts->_sweep = false;
+
+    /* Read options for lower bounds and the solver. */
+    for (int i = 2; i < argc; i++) {
+        string arg(argv[i]);
+        if (arg.compare("ALL") == 0) {
+            opts->_use_BB_lower_bound = true;
+            opts->_use_onetree_lower_bound = true;
+        }
+        else if (arg.compare("AUTO") == 0) {
             opts->_use_BB_lower_bound = true;
             opts->_use_onetree_lower_bound = true;
+            opts->_adaptive_lower_bound = true;
         }
-        if (bound_arg.compare("OT") == 0) {
+        else if (arg.compare("OT") == 0) {
             opts->_use_BB_lower_bound = false;
             opts->_use_onetree_lower_bound = true;
         }
-        if (bound_arg.compare("BB") == 0) {
+        else if (arg.compare("BB") == 0) {
             opts-> _use_BB_lower_bound = true;
             opts->_use_onetree_lower_bound = false;
         }
-        if (bound_arg.compare("NONE") == 0) {
+        else if (arg.compare("NONE") == 0) {
             opts->_use_BB_lower_bound = false;
             opts-> _use_onetree_lower_bound = false;
         }
+        else if (arg.compare("DA") == 0) {
+            opts->_use_BB_lower_bound = true;
+            opts->_use_onetree_lower_bound = false;
+            opts->_use_dual_ascent_lower_bound = true;
+        }
+        else if (arg.compare("--queue") == 0 && i + 1 < argc) {
+            string queue_arg(argv[++i]);
+            if (queue_arg.compare("heap") == 0)
+                solver_opts->_queue_type = HEAP_QUEUE;
+            else if (queue_arg.compare("bucket") == 0)
+                solver_opts->_queue_type = BUCKET_QUEUE;
+            else {
+                cout << "Main: Unknown queue type: " << queue_arg << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--nearest") == 0 && i + 1 < argc) {
+            string nearest_arg(argv[++i]);
+            if (nearest_arg.compare("off") == 0)
+                opts->_nearest_mode = NEAREST_OFF;
+            else if (nearest_arg.compare("eager") == 0)
+                opts->_nearest_mode = NEAREST_EAGER;
+            else if (nearest_arg.compare("lazy") == 0)
+                opts->_nearest_mode = NEAREST_LAZY;
+            else {
+                cout << "Main: Unknown mode for nearest terminals: " << 
+                        nearest_arg << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--nearest-memory") == 0 && i + 1 < argc) {
+            int megabytes = atoi(argv[++i]);
+            if (megabytes < 1) {
+                cout << "Main: Invalid memory bound: " << argv[i] << "\n";
+                exit(1);
+            }
+            opts->_nearest_max_memory = (uint64_t) megabytes << 20;
+        }
+        else if (arg.compare("--dense") == 0 && i + 1 < argc) {
+            string dense_arg(argv[++i]);
+            if (dense_arg.compare("off") == 0)
+                opts->_subset_mode = SUBSET_HASHED;
+            else if (dense_arg.compare("lazy") == 0)
+                opts->_subset_mode = SUBSET_DENSE_LAZY;
+            else if (dense_arg.compare("eager") == 0)
+                opts->_subset_mode = SUBSET_DENSE_EAGER;
+            else {
+                cout << "Main: Unknown mode for dense tables: " << 
+                        dense_arg << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--dense-memory") == 0 && i + 1 < argc) {
+            int megabytes = atoi(argv[++i]);
+            if (megabytes < 1) {
+                cout << "Main: Invalid memory bound: " << argv[i] << "\n";
+                exit(1);
+            }
+            opts->_subset_max_memory = (uint64_t) megabytes << 20;
+        }
+        else if (arg.compare("--reduce") == 0 && i + 1 < argc) {
+            string reduce_arg(argv[++i]);
+            if (reduce_arg.compare("on") == 0)
+                reduce = true;
+            else if (reduce_arg.compare("off") == 0)
+                reduce = false;
+            else {
+                cout << "Main: Unknown reduction mode: " << reduce_arg << 
+                        "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--lazy") == 0 && i + 1 < argc) {
+            string lazy_arg(argv[++i]);
+            if (lazy_arg.compare("on") == 0)
+                opts->_lazy_lower_bound = true;
+            else if (lazy_arg.compare("off") == 0)
+                opts->_lazy_lower_bound = false;
+            else {
+                cout << "Main: Unknown lazy bound mode: " << lazy_arg << 
+                        "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--prefetch") == 0 && i + 1 < argc) {
+            string prefetch_arg(argv[++i]);
+            if (prefetch_arg.compare("on") == 0)
+                opts->_prefetch_subsets = true;
+            else if (prefetch_arg.compare("off") == 0)
+                opts->_prefetch_subsets = false;
+            else {
+                cout << "Main: Unknown prefetch mode: " << prefetch_arg << 
+                        "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--eliminate") == 0 && i + 1 < argc) {
+            string eliminate_arg(argv[++i]);
+            eliminate_given = true;
+            if (eliminate_arg.compare("on") == 0)
+                solver_opts->_eliminate = true;
+            else if (eliminate_arg.compare("off") == 0)
+                solver_opts->_eliminate = false;
+            else {
+                cout << "Main: Unknown elimination mode: " << 
+                        eliminate_arg << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--heuristic") == 0 && i + 1 < argc) {
+            string heuristic_arg(argv[++i]);
+            if (heuristic_arg.compare("on") == 0)
+                solver_opts->_heuristic = true;
+            else if (heuristic_arg.compare("off") == 0)
+                solver_opts->_heuristic = false;
+            else {
+                cout << "Main: Unknown heuristic mode: " << 
+                        heuristic_arg << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--sweep") == 0 && i + 1 < argc) {
+            string sweep_arg(argv[++i]);
+            if (sweep_arg.compare("on") == 0)
+                solver_opts->_sweep = true;
+            else if (sweep_arg.compare("off") == 0)
+                solver_opts->_sweep = false;
+            else {
+                cout << "Main: Unknown sweep mode: " << sweep_arg << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--tree") == 0)
+            tree = true;
+        else if (arg.compare("--stats") == 0)
+            stats = true;
+        else if (arg.compare("--threads") == 0 && i + 1 < argc) {
+            solver_opts->_n_threads = atoi(argv[++i]);
+            if (solver_opts->_n_threads < 1) {
+                cout << "Main: Invalid number of threads: " << 
+                        argv[i] << "\n";
+                exit(1);
+            }
+        }
+        else if (arg.compare("--simd") == 0 && i + 1 < argc) {
+            string simd_arg(argv[++i]);
+            SimdLevel level = SIMD_SCALAR;
+            if (simd_arg.compare("avx2") == 0)
+                level = SIMD_AVX2;
+            else if (simd_arg.compare("avx512") == 0)
+                level = SIMD_AVX512;
+            else if (simd_arg.compare("scalar") != 0) {
+                cout << "Main: Unknown instruction set: " << simd_arg << "\n";
+                exit(1);
+            }
+            if (SetSimdLevel(level) == FAIL) {
+                cout << "Main: Instruction set not supported: " << 
+                        simd_arg << "\n";
+                exit(1);
+            }
+        }
+        else {
+            cout << "Main: Unknown option: " << arg << "\n";
+            exit(1);
+        }
+    }
+
+    if (!eliminate_given)
+        solver_opts->_eliminate = opts->_use_dual_ascent_lower_bound;
+
+    /* AUTO changes the keys of labels in N, which needs decrease-key. */
+    if (opts->_adaptive_lower_bound && 
+        solver_opts->_queue_type != BUCKET_QUEUE) {
+        cout << "Main: AUTO needs the bucket queue.\n";
+        exit(1);
     }
 
+    int n_removed = 0;
+    if (reduce)
+        inst->ReduceHananGrid(n_removed);
+
     BoundComputator *bound_comp = new BoundComputator(inst, opts);
-    Solver *S = new Solver(inst, bound_comp);
+    Solver *S = new Solver(inst, bound_comp, solver_opts);
 
     int solution;
     if (S->SolveCurrentInstance(solution) == FAIL) {
@@ -69,6 +289,62 @@ int main(int argc, char* argv[]) {
 
     cout << solution << "\n";
 
+    int divisor = DOUBLE_INPUT_COORDS ? 2 : 1;
+    if (tree) {
+        vector<TreeSegment> segments;
+        vector<Vertex*> steiner_points;
+        if (S->GetSolutionTree(segments, steiner_points) == FAIL) {
+            cout << "Main: No tree available.\n";
+            exit(1);
+        }
+        cout << "Steiner points: " << steiner_points.size() << "\n";
+        for (unsigned int i = 0; i < steiner_points.size(); i++) {
+            Vertex *v = steiner_points[i];
+            cout << v->GetX() / divisor << " " << v->GetY() / divisor << 
+                    " " << v->GetZ() / divisor << "\n";
+        }
+        cout << "Segments: " << segments.size() << "\n";
+        for (unsigned int i = 0; i < segments.size(); i++) {
+            const TreeSegment &e = segments[i];
+            cout << e._x1 / divisor << " " << e._y1 / divisor << " " << 
+                    e._z1 / divisor << " " << e._x2 / divisor << " " << 
+                    e._y2 / divisor << " " << e._z2 / divisor << "\n";
+        }
+    }
+
+    if (stats) {
+        cout << "MST upper bound: " << S->GetMSTUpperBound() / divisor << 
+                "\nGlobal upper bound: " << 
+                S->GetGlobalUpperBound() / divisor << 
+                "\nVertices: " << inst->GetNVertices() << 
+                "\nRemoved vertices: " << n_removed << 
+                "\nEliminated vertices: " << S->GetNEliminatedVertices() << 
+                "\nLabels: " << S->GetNLabels() << 
+                "\nRetired labels: " << S->GetNRetiredLabels() << 
+                "\nLabel table memory: " << 
+                S->GetLabelTableMemoryUsage() / 1024 << "KB\n";
+
+        const SubsetTable *subsets = bound_comp->GetSubsetTable();
+        cout << "Subset table: " << 
+                (subsets->IsDense() ? "dense" : "hashed") << 
+                "\nSubset records: " << subsets->GetNRecords() << " of " << 
+                subsets->GetCapacity() << 
+                "\nSubset probe length: " << 
+                subsets->GetAverageProbeLength() << " average, " << 
+                subsets->GetMaxProbeLength() << " maximum" << 
+                "\nSubset table memory: " << 
+                subsets->GetMemoryUsage() / 1024 << "KB\n";
+
+        const MSTEngine *mst_engine = bound_comp->GetMSTEngine();
+        cout << "MSTs computed: " << mst_engine->GetNComputed() << 
+                "\nMSTs derived: " << mst_engine->GetNDerived() << "\n";
+
+        const NearestTerminals *nearest = bound_comp->GetNearestTerminals();
+        if (nearest != NULL)
+            cout << "Nearest terminal lists: " << 
+                    nearest->GetMemoryUsage() / 1024 << "KB\n";
+    }
+
     delete inst;
     delete bound_comp;
     delete S;
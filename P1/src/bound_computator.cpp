@@ -20,75 +20,175 @@ BoundComputator::BoundComputator(Instance *inst, BoundOptions *opts) {
     _terminals = inst->GetTerminals();
 
     /* Extract lower bound options */
+    NearestMode nearest_mode = NEAREST_OFF;
+    uint64_t nearest_max_memory = 0;
+    SubsetMode subset_mode = SUBSET_HASHED;
+    uint64_t subset_max_memory = 0;
+    bool prefetch_subsets = false;
     if (opts != NULL) {
         _use_BB_lower_bound = opts->_use_BB_lower_bound;
         _use_onetree_lower_bound = opts->_use_onetree_lower_bound;
+        _use_dual_ascent_lower_bound = opts->_use_dual_ascent_lower_bound;
+        _lazy_lower_bound = opts->_lazy_lower_bound;
+        _adaptive_lower_bound = opts->_adaptive_lower_bound;
+        nearest_mode = opts->_nearest_mode;
+        nearest_max_memory = opts->_nearest_max_memory;
+        subset_mode = opts->_subset_mode;
+        subset_max_memory = opts->_subset_max_memory;
+        prefetch_subsets = opts->_prefetch_subsets;
         free(opts);
     }
     /* By default use BB and OneTree lower bounds. */
     else {
         _use_BB_lower_bound = true;
         _use_onetree_lower_bound = true;    
+        _use_dual_ascent_lower_bound = false;
+        _lazy_lower_bound = false;
+        _adaptive_lower_bound = false;
     }
+    _dual_ascent = NULL;
+    _onetree_min_size = _n_terminals;
+    if (nearest_max_memory == 0)
+        nearest_max_memory = NEAREST_DEFAULT_MAX_MEMORY;
+    if (subset_max_memory == 0)
+        subset_max_memory = SUBSET_DENSE_DEFAULT_MAX_MEMORY;
+
+    /* Store the coordinates of the terminals as a structure of arrays,
+     * padded for the SIMD kernels. */
+    _terminal_mask = (_n_terminals == 64) ? ~(uint64_t) 0 : 
+                     ((uint64_t) 1 << _n_terminals) - 1;
+    int n_padded = ((_n_terminals + SIMD_PAD - 1) / SIMD_PAD) * SIMD_PAD;
+    _terminal_x = (int32_t*) aligned_alloc(SIMD_ALIGN, 
+                                           n_padded * sizeof(int32_t));
+    _terminal_y = (int32_t*) aligned_alloc(SIMD_ALIGN, 
+                                           n_padded * sizeof(int32_t));
+    _terminal_z = (int32_t*) aligned_alloc(SIMD_ALIGN, 
+                                           n_padded * sizeof(int32_t));
+    for (int i = 0; i < n_padded; i++) {
+        _terminal_x[i] = (i < _n_terminals) ? _terminals[i]->GetX() : 0;
+        _terminal_y[i] = (i < _n_terminals) ? _terminals[i]->GetY() : 0;
+        _terminal_z[i] = (i < _n_terminals) ? _terminals[i]->GetZ() : 0;
+    }
+
+    SetRankTables();
+    _mst_engine = new MSTEngine(_terminal_x, _terminal_y, _terminal_z,
+                                _n_terminals);
+
+    /* Use a dense subset table if requested and if it is small enough,
+     * and a hashed one otherwise. */
+    bool dense = subset_mode != SUBSET_HASHED && _n_terminals >= 2 &&
+                 _n_terminals < BITSET_SIZE &&
+                 SubsetTable::DenseMemoryUsage(_n_terminals) <= 
+                    subset_max_memory;
+    _subset_table = new SubsetTable(dense, _n_terminals);
+    _precompute_subset_table = dense && subset_mode == SUBSET_DENSE_EAGER;
+
+    /* The worker only reads the terminals and the distances between them,
+     * like PrecomputeSubsetTable. There is nothing to prefetch if the 
+     * table is filled in advance. */
+    _prefetcher = NULL;
+    if (prefetch_subsets && !_precompute_subset_table) {
+        bool lazy_MST = _use_onetree_lower_bound && _lazy_lower_bound;
+        _prefetcher = new SubsetPrefetcher([this, lazy_MST](
+                PrefetchedSubset &s) {
+            ComplementDistance(bitset<BITSET_SIZE>(s._mask), s._distance,
+                               s._distance_ind);
+            s._MST = lazy_MST ? _mst_engine->ComputeMST(~s._mask) :
+                                SUBSET_NOT_COMPUTED;
+        });
+    }
+
+    _nearest_terminals = NULL;
+    if (nearest_mode != NEAREST_OFF)
+        _nearest_terminals = new NearestTerminals(_terminal_x, _terminal_y,
+                                    _terminal_z, _n_terminals, 
+                                    inst->GetVertices(), nearest_mode, 
+                                    nearest_max_memory);
+}
+
+BoundComputator::~BoundComputator() {
+    /* Stop the prefetcher before freeing what its worker reads. */
+    delete _prefetcher;
+    free(_terminal_x);
+    free(_terminal_y);
+    free(_terminal_z);
+    free(_rank_tables);
+    delete _mst_engine;
+    delete _subset_table;
+    delete _nearest_terminals;
+    delete _dual_ascent;
+}
+
+Result BoundComputator::SetRankTables() {
+    const int32_t *coords[3] = { _terminal_x, _terminal_y, _terminal_z };
+    _n_rank_bytes = (_n_terminals + 7) / 8;
+    _rank_tables = (uint64_t*) calloc(3 * _n_rank_bytes * 256, 
+                                      sizeof(uint64_t));
+
+    for (int axis = 0; axis < 3; axis++) {
+        /* Sort the terminals along the axis. */
+        vector<int> order(_n_terminals);
+        for (int i = 0; i < _n_terminals; i++)
+            order[i] = i;
+        stable_sort(order.begin(), order.end(), [&](int i, int j) {
+            return coords[axis][i] < coords[axis][j];
+        });
+
+        uint64_t *table = _rank_tables + axis * _n_rank_bytes * 256;
+        for (int rank = 0; rank < _n_terminals; rank++) {
+            int i = order[rank];
+            _sorted_coords[axis][rank] = coords[axis][i];
+            _sorted_terminals[axis][rank] = i;
+
+            /* Add the rank of terminal i to each byte value containing
+             * the bit of i. */
+            int byte = i / 8;
+            for (int m = 0; m < 256; m++) {
+                if (m & (1 << (i % 8)))
+                    table[(byte << 8) | m] |= (uint64_t) 1 << rank;
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+Result BoundComputator::TerminalDistances(Vertex *v, int32_t *ret_dists) {
+    RectDistances(_terminal_x, _terminal_y, _terminal_z, _n_terminals,
+                  v->GetX(), v->GetY(), v->GetZ(), ret_dists);
+    return SUCCESS;
 }
 
 PerimeterCoords BoundComputator::Perimeter(const bitset<BITSET_SIZE> &I) {    
+    uint64_t C = ~I.to_ullong() & _terminal_mask;
+
     /* Empty terminal set. */
-    if (!I.any()) {
+    if (C == 0) {
         cout << "ERROR: Perimeter called for empty terminal set\n";        
         exit(1);
     }
 
-    int x_max, x_min;
-    int y_max, y_min;
-    int z_max, z_min;
-    
-    x_min = y_min = z_min = MAX_COORD * (1 + DOUBLE_INPUT_COORDS);
-    x_max = y_max = z_max = 0;
-
-    /* Loop over all terminals in the complement of the labels
-     * terminal set and update values accordingly */
-    for (int i = 0; i < _n_terminals; i++) {
-        if (!I.test(i)) {
-            if (_terminals[i]->GetX() < x_min)
-                x_min = _terminals[i]->GetX();
-            if (_terminals[i]->GetX() > x_max)
-                x_max = _terminals[i]->GetX();
-            if (_terminals[i]->GetY() < y_min)
-                y_min = _terminals[i]->GetY();
-            if (_terminals[i]->GetY() > y_max)
-                y_max = _terminals[i]->GetY();
-            if (_terminals[i]->GetZ() < z_min)
-                z_min = _terminals[i]->GetZ();
-            if (_terminals[i]->GetZ() > z_max)
-                z_max = _terminals[i]->GetZ();
-        }
-    }
-
+    /* The extreme coordinates of the terminals in the complement of
+     * the labels terminal set are those of the terminals with the 
+     * lowest and highest rank along each axis. */
     PerimeterCoords ret;
-    ret._x_max = x_max;
-    ret._x_min = x_min;
-    ret._y_max = y_max;
-    ret._y_min = y_min;
-    ret._z_max = z_max;
-    ret._z_min = z_min;
+    uint64_t ranks = RankMask(0, C);
+    ret._x_min = _sorted_coords[0][__builtin_ctzll(ranks)];
+    ret._x_max = _sorted_coords[0][63 - __builtin_clzll(ranks)];
+    ranks = RankMask(1, C);
+    ret._y_min = _sorted_coords[1][__builtin_ctzll(ranks)];
+    ret._y_max = _sorted_coords[1][63 - __builtin_clzll(ranks)];
+    ranks = RankMask(2, C);
+    ret._z_min = _sorted_coords[2][__builtin_ctzll(ranks)];
+    ret._z_max = _sorted_coords[2][63 - __builtin_clzll(ranks)];
     return ret;
 }
 
 int BoundComputator::BBLowerBound(Label *l) {
-    bitset<BITSET_SIZE> I = l->GetBitset();
+    uint64_t C = ~l->GetBitset().to_ullong() & _terminal_mask;
+    if (__builtin_popcountll(C) == 3)
+        return SmallSteinerLength(l->GetVertex(), C);
 
-    /* Try to fetch the perimeter from the hash table, 
-     * compute it otherwise. */
-    PerimeterCoords I_perimeter;
-    auto it = _perimeter_hash.find(I);
-    if (it != _perimeter_hash.end()) {
-        I_perimeter = it->second;
-    } 
-    else {
-        I_perimeter = Perimeter(I);
-        _perimeter_hash.insert(make_pair(I, I_perimeter));
-    }
+    PerimeterCoords I_perimeter = Perimeter(l->GetBitset());
 
     int x_max = max(l->GetVertex()->GetX(), I_perimeter._x_max);
     int x_min = min(l->GetVertex()->GetX(), I_perimeter._x_min);
@@ -100,58 +200,62 @@ int BoundComputator::BBLowerBound(Label *l) {
     return (x_max - x_min) + (y_max - y_min) + (z_max - z_min);
 }
 
-int BoundComputator::MST(const bitset<BITSET_SIZE> &I) {
-    
-    vector<Vertex*> terminals_in_I;
-    for (int i = 0; i < _n_terminals; i++){
-        if (I.test(i))
-            terminals_in_I.push_back(_terminals[i]);
-    }
-
-    int n_terminals_in_I = terminals_in_I.size();
-
-    /* An MST on <= 1 vertex has length 0. */
-    if (n_terminals_in_I <= 1)
-        return 0;
- 
-    /* Array containing cheapest cost of a connection to each vertex. 
-     * Initially set all values to infinity except for costs[0]. */
-    vector<int> costs(n_terminals_in_I, INT_MAX);
-    costs[0] = 0;
-
-    /* Array indicating which terminals are already in the tree,
-     * initially add the first one. */
-    vector<bool> in_tree(n_terminals_in_I, false);
-
-    int min = INT_MAX;
-    int min_index = 0;
-    int tree_cost = 0;
-    int cur_distance;
-
-    for (int j = 0; j < n_terminals_in_I; j++) {
-        min = INT_MAX;
-        /* Find terminal with minimum cost and add it to tree. */
-        for (int i = 0; i < n_terminals_in_I; i++) {
-            if (costs[i] < min && !in_tree[i]) {
-                min = costs[i];
-                min_index = i;
-            }
+int BoundComputator::SmallSteinerLength(Vertex *v, uint64_t C) const {
+    const int v_coords[3] = { v->GetX(), v->GetY(), v->GetZ() };
+    int partners[3], gaps[3];
+    int length = 0, total_gap = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        uint64_t ranks = RankMask(axis, C);
+        int lo = __builtin_ctzll(ranks);
+        int mid = __builtin_ctzll(ranks & (ranks - 1));
+        int hi = 63 - __builtin_clzll(ranks);
+        int x = v_coords[axis];
+        int x_lo = _sorted_coords[axis][lo];
+        int x_mid = _sorted_coords[axis][mid];
+        int x_hi = _sorted_coords[axis][hi];
+        length += max(x, x_hi) - min(x, x_lo);
+
+        /* v is on the same side of the median interval as the minimum
+         * or the maximum of C. */
+        if (x <= x_mid) {
+            gaps[axis] = x_mid - max(x, x_lo);
+            partners[axis] = _sorted_terminals[axis][lo];
+        }
+        else {
+            gaps[axis] = min(x, x_hi) - x_mid;
+            partners[axis] = _sorted_terminals[axis][hi];
         }
+        total_gap += gaps[axis];
+    }
 
-        /* Update terminal costs and total tree cost. */
-        tree_cost += costs[min_index];
-        in_tree[min_index] = true;
-        for (int i = 0; i < n_terminals_in_I; i++) {
-            cur_distance = RectDistance(terminals_in_I[i], 
-                                        terminals_in_I[min_index]);
-            if (cur_distance < costs[i] && i != min_index) {
-                costs[i] = cur_distance;
-            }
+    /* Pair v with the terminal saving the most. */
+    int best_saving = 0;
+    for (int axis = 0; axis < 3; axis++) {
+        int saving = 0;
+        for (int other = 0; other < 3; other++) {
+            if (partners[other] == partners[axis])
+                saving += gaps[other];
         }
+        best_saving = max(best_saving, saving);
     }
+    return length + total_gap - best_saving;
+}
+
+int BoundComputator::MST(const bitset<BITSET_SIZE> &I) {
+    return _mst_engine->ComputeMST(I.to_ullong());
+}
 
-    return tree_cost;
- }
+int BoundComputator::GetComplementMST(const bitset<BITSET_SIZE> &I) {
+    /* Only insert a record if MST(R-I) is not yet known, so that this
+     * only reads from the subset table after PrepareLowerBound. */
+    const SubsetRecord *r = _subset_table->Find(I.to_ullong());
+    if (r != NULL && r->_MST != SUBSET_NOT_COMPUTED)
+        return r->_MST;
+
+    int MST_length = _mst_engine->GetMST(~I.to_ullong());
+    _subset_table->FindOrInsert(I.to_ullong())->_MST = MST_length;
+    return MST_length;
+}
 
 int BoundComputator::OneTreeLowerBound(Label *l) {
 
@@ -161,38 +265,21 @@ int BoundComputator::OneTreeLowerBound(Label *l) {
     bitset<BITSET_SIZE> I = l->GetBitset();
     bitset<BITSET_SIZE> C = ~l->GetBitset();
 
-    /* Find length of MST on C. First check if it was computed already. 
-     * If not, compute it and add it to the hash table. */
-    int MST_length;
-    auto it = _MST_hash.find(I);
-    if (it != _MST_hash.end()) {
-        MST_length = it->second;
-    } 
-    else {
-        MST_length = MST(C);
-        _MST_hash.insert(make_pair(I, MST_length));
-    }
+    /* For small R-I the bounding box lower bound is exact. */
+    if (_n_terminals - I.count() <= 3)
+        return BBLowerBound(l);
+
+    /* Find length of MST on C. */
+    int MST_length = GetComplementMST(I);
     
     /* Find terminal in C closest to v and second closest to v. */
-    int min_dist = INT_MAX;
-    int snd_min_dist = INT_MAX;
-    int min_index;
-    int cur_dist;
-    for (int i = 0; i < _n_terminals; i++) {
-        if (C.test(i)) {
-            if ((cur_dist = RectDistance(v, _terminals[i])) < min_dist) {
-                snd_min_dist = min_dist;
-                min_dist = cur_dist;
-                min_index = i;
-            }
-            if (i != min_index && cur_dist < snd_min_dist)
-                snd_min_dist = cur_dist;
-        }
-    }
-
-    /* Case for |C| = 1: */
-    if (_n_terminals - I.count() == 1)
-        return (MST_length / 2) + min_dist;
+    alignas(SIMD_ALIGN) int32_t dists[BITSET_SIZE];
+    TerminalDistances(v, dists);
+    uint64_t C_mask = C.to_ullong() & _terminal_mask;
+    int min_index, snd_min_index;
+    int min_dist = MaskedMin(dists, C_mask, min_index);
+    int snd_min_dist = MaskedMin(dists, C_mask & ~((uint64_t) 1 << min_index),
+                                 snd_min_index);
 
     /* If snd_min_dist is still infty at this point something
      * is very wrong. */
@@ -201,45 +288,32 @@ int BoundComputator::OneTreeLowerBound(Label *l) {
         exit(1);
     }
 
-    /* Case for |C| > 1: */
     return (MST_length / 2) + (min_dist + snd_min_dist) / 2;
 }
 
 Result BoundComputator::ComplementDistance(const bitset<BITSET_SIZE> &I,
-                                           int &ret_dist,
-                                           int &ret_ind) {
+                                           int32_t &ret_dist,
+                                           int32_t &ret_ind) {
     
-    /* Get the coordinates i for which terminals[i] is in I and
-     * those for which it is not. */
-    vector<int> indices_in_I;
-    vector<int> indices_not_in_I;
-    for (int i = 0; i < _n_terminals; i++) {
-        if (I.test(i))
-            indices_in_I.push_back(i);
-        else
-            indices_not_in_I.push_back(i);
-    }
+    uint64_t I_mask = I.to_ullong() & _terminal_mask;
+    uint64_t C_mask = ~I.to_ullong() & _terminal_mask;
 
     /* I and R-I should never be empty! */
-    if (indices_in_I.size() == 0 || indices_not_in_I.size() == 0) {
+    if (I_mask == 0 || C_mask == 0) {
         cout << "ERROR: computing d(R, I-R) for empty I or empty I-R. \n";
         exit(1); 
     }
 
-    /* Now find d(I, R-I) by finding d(i, j) for all i in I and 
-     * j in R-I. */
+    /* Now find d(I, R-I) by finding d(i, R-I) for all i in I. */
     int min = INT_MAX;
-    int min_ind;
-    int cur_dist;
-    for (unsigned int i = 0; i < indices_in_I.size(); i++) {
-        for (unsigned int j = 0; j < indices_not_in_I.size(); j++) {
-            int k = indices_in_I[i];
-            int l = indices_not_in_I[j];
-            if ((cur_dist = RectDistance(_terminals[k], _terminals[l])) 
-                    < min) {
-                min = cur_dist;
-                min_ind = l;
-            }
+    int min_ind = -1;
+    int cur_dist, cur_ind;
+    for (; I_mask != 0; I_mask &= I_mask - 1) {
+        const int32_t *dists = 
+            _mst_engine->GetDistances(__builtin_ctzll(I_mask));
+        if ((cur_dist = MaskedMin(dists, C_mask, cur_ind)) < min) {
+            min = cur_dist;
+            min_ind = cur_ind;
         }
     }
 
@@ -255,89 +329,68 @@ Result BoundComputator::VertexComplementDistance(
         int &ret_dist, 
         int &ret_ind) {
 
-    int min = INT_MAX;
-    int min_ind;
-    int cur_dist;
-    /* Loop over all terminals in R-I to find the closest one to v. */
-    for (int i = 0; i < _n_terminals; i++) {
-        if (!I.test(i) && (cur_dist = RectDistance(v, _terminals[i])) < min) {
-            min = cur_dist;
-            min_ind = i;
-        }
-    }
+    /* Walk the list of terminals ordered by distance to v if it is 
+     * available, otherwise check all terminals in R-I. */
+    if (_nearest_terminals != NULL && 
+        _nearest_terminals->GetNearest(v, I.to_ullong(), ret_dist, ret_ind)
+            == SUCCESS)
+        return SUCCESS;
 
-    ret_dist = min;
-    ret_ind = min_ind;
+    alignas(SIMD_ALIGN) int32_t dists[BITSET_SIZE];
+    TerminalDistances(v, dists);
+    ret_dist = MaskedMin(dists, ~I.to_ullong() & _terminal_mask, ret_ind);
     return SUCCESS;
 }
 
 bool BoundComputator::CompareToUpperBound(Label* l) {
-    bitset<BITSET_SIZE> I = l->GetBitset();
+    return CompareToUpperBound(l->GetBitset(), l->GetL());
+}
 
-    /* Attempt to fetch U(I) from the hash table */
-    auto it = _upper_bound_hash.find(I);
-    /* If A(I) is set, compare U(I) to value. */
-    if (it != _upper_bound_hash.end()) {
-        return (l->GetL() > it->second.first);
-    } 
-    /* If A(I) is not set (i.e. U(I) = infty) we 
-     * return false. */
-    else
-        return false;
+bool BoundComputator::CompareToUpperBound(const bitset<BITSET_SIZE> &I, 
+                                          int l) {
+    /* Attempt to fetch U(I) from the subset table. If A(I) is not set 
+     * (i.e. U(I) = infty) we return false. */
+    const SubsetRecord *r = _subset_table->Find(I.to_ullong());
+    return (r != NULL && l > r->_U);
 }
 
-Result BoundComputator::GetComplementDistance(const bitset<BITSET_SIZE> &I,
+Result BoundComputator::GetComplementDistance(SubsetRecord *r,
                                               int &ret_dist,
                                               int &ret_ind) {
-    /* Attempt to fetch d(I, R-I) from the hash table. */
-    auto it = _distance_hash.find(I);
-    /* If d(I, R-I) set return it. */
-    if (it != _distance_hash.end()) {
-        ret_dist = it->second.first;
-        ret_ind = it->second.second;
-    } 
-    /* If R-I not set, compute it, insert it in the hash table,
-     * and return it. */
-    else {
-        ComplementDistance(I, ret_dist, ret_ind);
-        _distance_hash.insert(make_pair(I, make_pair(ret_dist, ret_ind)));
-    }
+    /* If d(I, R-I) is not set, compute it and store it in the record. */
+    if (r->_distance == SUBSET_NOT_COMPUTED)
+        ComplementDistance(bitset<BITSET_SIZE>(r->_mask), r->_distance, 
+                           r->_distance_ind);
+    ret_dist = r->_distance;
+    ret_ind = r->_distance_ind;
     return SUCCESS;
 }
 
 Result BoundComputator::UpdateUpperBound(Label *l) {
-    
-    bitset<BITSET_SIZE> I = l->GetBitset();
+    return UpdateUpperBound(l->GetBitset(), l->GetVertex(), l->GetL());
+}
+
+Result BoundComputator::UpdateUpperBound(const bitset<BITSET_SIZE> &I,
+                                         Vertex *v, int l) {
+    SubsetRecord *r = _subset_table->FindOrInsert(I.to_ullong());
 
     /* Compute l(v,I) + min (d(I, R-I), d(v, R-I)) and the index 
      * of the terminal in R-I closest to v or closest to I,
      * accordingly. */
     int vertex_dist, vertex_ind, compl_dist, compl_ind, min_ind;
-    GetComplementDistance(I, compl_dist, compl_ind);
-    VertexComplementDistance(I, l->GetVertex(), vertex_dist, vertex_ind);
+    GetComplementDistance(r, compl_dist, compl_ind);
+    VertexComplementDistance(I, v, vertex_dist, vertex_ind);
     if (vertex_dist < compl_dist)
         min_ind = vertex_ind;
     else
         min_ind = compl_ind;
-    int value = l->GetL() + min(compl_dist, vertex_dist);
-
-    /* Attempt to fetch A(I) */
-    auto it = _upper_bound_hash.find(I);
-    /* If A(I) set, compare U(I) to value and update U(I) 
-     * and S(I) if needed. */
-    if (it != _upper_bound_hash.end()) {
-        if (value < it->second.first) {
-            _upper_bound_hash[I].first = value;   
-            bitset<BITSET_SIZE> new_S;
-            new_S.set(min_ind);
-            _upper_bound_hash[I].second = new_S;
-        }
-    } 
-    /* If A(I) not set (i.e. U(I) = infty) then set it. */
-    else {
-        bitset<BITSET_SIZE> new_S;
-        new_S.set(min_ind);
-        _upper_bound_hash.insert(make_pair(I, make_pair(value, new_S)));
+    int value = l + min(compl_dist, vertex_dist);
+
+    /* Compare U(I) to value and update U(I) and S(I) if needed. If
+     * A(I) is not set, then U(I) = infty. */
+    if (value < r->_U) {
+        r->_U = value;
+        r->_S = (uint64_t) 1 << min_ind;
     }
 
     return SUCCESS;
@@ -347,51 +400,164 @@ Result BoundComputator::MergeUpperBound(const bitset<BITSET_SIZE> &I,
                                         const bitset<BITSET_SIZE> &J) {
 
     /* If either A(I) or A(J) is not set we should not do anything. */
-    auto it_I = _upper_bound_hash.find(I);
-    auto it_J = _upper_bound_hash.find(J);
-    if (it_I == _upper_bound_hash.end() || it_J == _upper_bound_hash.end())
+    uint64_t I_mask = I.to_ullong();
+    uint64_t J_mask = J.to_ullong();
+    const SubsetRecord *r_I = _subset_table->Find(I_mask);
+    const SubsetRecord *r_J = _subset_table->Find(J_mask);
+    if (r_I == NULL || r_I->_U == SUBSET_NO_UPPER_BOUND || 
+        r_J == NULL || r_J->_U == SUBSET_NO_UPPER_BOUND)
         return FAIL;
 
-    bitset<BITSET_SIZE> IJ = I | J;
-
     /* Check if S(I) \cap J or I \cap S(J) is empty. If not, nothing 
      * is to be done. */
-    if ((_upper_bound_hash[I].second & J).any() && 
-        (_upper_bound_hash[J].second & I).any())
+    if ((r_I->_S & J_mask) && (r_J->_S & I_mask))
         return FAIL;
 
     /* Find U(I) + U(J) and (S(I) u S(J)) - (I u J). */
-    int sum_U = _upper_bound_hash[I].first + _upper_bound_hash[J].first;
-
-    /* First find union then remove I and J. */
-    bitset<BITSET_SIZE> new_S = _upper_bound_hash[I].second | 
-                                _upper_bound_hash[J].second;
-    new_S = (new_S & ~I) & ~J;
-
-    /* Attempt to fetch A(IuJ). */
-    auto it = _upper_bound_hash.find(IJ);
-    /* If A(I u J) set: Check if U(I) + U(J) < U(IuJ) 
-     * and update U(I u J) and S(I u J) if so. */
-    if (it != _upper_bound_hash.end()) {
-        if (sum_U < it->second.first) {
-            it->second.first = sum_U;
-            it->second.second = new_S;
-        }
-    } 
-    /* If A(I u J) not set, set it.*/
-    else {
-        _upper_bound_hash.insert(make_pair(IJ, make_pair(sum_U, new_S)));
+    int sum_U = r_I->_U + r_J->_U;
+    uint64_t new_S = (r_I->_S | r_J->_S) & ~(I_mask | J_mask);
+
+    /* Check if U(I) + U(J) < U(IuJ) and update U(I u J) and S(I u J) 
+     * if so. Inserting A(I u J) may move the records of I and J. */
+    SubsetRecord *r_IJ = _subset_table->FindOrInsert(I_mask | J_mask);
+    if (sum_U < r_IJ->_U) {
+        r_IJ->_U = sum_U;
+        r_IJ->_S = new_S;
     }
 
     return SUCCESS;
 }
 
+Result BoundComputator::PrepareLowerBound(const bitset<BITSET_SIZE> &I) {
+    /* The bounding box lower bound does not use the subset table. */
+    if (_use_onetree_lower_bound && !_lazy_lower_bound)
+        GetComplementMST(I);
+    return SUCCESS;
+}
+
 int BoundComputator::GetLowerBound(Label *l) {
-    if (_use_BB_lower_bound && _use_onetree_lower_bound)
-        return max(BBLowerBound(l), OneTreeLowerBound(l));
+    int lb = 0;
     if (_use_BB_lower_bound)
-        return BBLowerBound(l);
+        lb = BBLowerBound(l);
     if (_use_onetree_lower_bound)
-        return OneTreeLowerBound(l);
-    return 0;
+        lb = max(lb, OneTreeLowerBound(l));
+    if (_use_dual_ascent_lower_bound)
+        lb = max(lb, DualAscentLowerBound(l));
+    return lb;
+}
+
+int BoundComputator::AdaptiveLowerBound(Label *l) {
+    int lb = BBLowerBound(l);
+    if ((int) l->GetBitset().count() >= _onetree_min_size)
+        lb = max(lb, OneTreeLowerBound(l));
+    return lb;
+}
+
+int BoundComputator::DualAscentLowerBound(Label *l) {
+    return _dual_ascent->LabelLowerBound(l->GetVertex(), 
+                                         l->GetBitset().to_ullong());
+}
+
+Result BoundComputator::ComputeDualAscent() {
+    if (!_use_dual_ascent_lower_bound || _dual_ascent != NULL)
+        return FAIL;
+    _dual_ascent = new DualAscent(_underlying_instance);
+    return _dual_ascent->Run();
+}
+
+Result BoundComputator::PrefetchSubset(const bitset<BITSET_SIZE> &I) {
+    if (_prefetcher == NULL)
+        return FAIL;
+    const SubsetRecord *r = _subset_table->Find(I.to_ullong());
+    if (r != NULL && r->_distance != SUBSET_NOT_COMPUTED && 
+        (r->_MST != SUBSET_NOT_COMPUTED || !_lazy_lower_bound || 
+         !_use_onetree_lower_bound))
+        return FAIL;
+    return _prefetcher->Submit(I.to_ullong());
+}
+
+Result BoundComputator::StorePrefetchedSubsets() {
+    if (_prefetcher == NULL)
+        return FAIL;
+    _prefetched.clear();
+    if (_prefetcher->Collect(_prefetched) == FAIL)
+        return FAIL;
+    for (unsigned int i = 0; i < _prefetched.size(); i++) {
+        const PrefetchedSubset &s = _prefetched[i];
+        SubsetRecord *r = _subset_table->FindOrInsert(s._mask);
+        if (r->_distance == SUBSET_NOT_COMPUTED) {
+            r->_distance = s._distance;
+            r->_distance_ind = s._distance_ind;
+        }
+        if (r->_MST == SUBSET_NOT_COMPUTED)
+            r->_MST = s._MST;
+    }
+    return SUCCESS;
+}
+
+Result BoundComputator::PrecomputeSubsetTable(ThreadPool *pool) {
+    if (!_precompute_subset_table)
+        return FAIL;
+
+    /* Each thread handles a contiguous range of records, so that no two
+     * threads write to the same cache line. The record at position p is
+     * that of I = 2p, and we skip the empty set at p = 0. */
+    uint64_t n_records = _subset_table->GetCapacity();
+    int n_threads = (pool == NULL) ? 1 : pool->GetNThreads();
+    auto task = [&](int t) {
+        uint64_t begin = max((uint64_t) 1, n_records * t / n_threads);
+        uint64_t end = n_records * (t + 1) / n_threads;
+        for (uint64_t p = begin; p < end; p++) {
+            uint64_t I = p << 1;
+            SubsetRecord *r = _subset_table->Find(I);
+            ComplementDistance(bitset<BITSET_SIZE>(I), r->_distance, 
+                               r->_distance_ind);
+            if (_use_onetree_lower_bound)
+                r->_MST = _mst_engine->ComputeMST(~I);
+        }
+    };
+    if (pool == NULL)
+        task(0);
+    else
+        pool->Run(task);
+    return SUCCESS;
+}
+
+bool BoundComputator::GetUseBBLowerBound() const { 
+    return _use_BB_lower_bound; 
+}
+
+bool BoundComputator::GetUseOneTreeLowerBound() const { 
+    return _use_onetree_lower_bound; 
+}
+
+bool BoundComputator::GetUseDualAscentLowerBound() const { 
+    return _use_dual_ascent_lower_bound; 
+}
+
+bool BoundComputator::GetLazyLowerBound() const { 
+    return _lazy_lower_bound; 
+}
+
+bool BoundComputator::GetAdaptiveLowerBound() const { 
+    return _adaptive_lower_bound; 
+}
+
+Result BoundComputator::SetOneTreeMinSize(int size) {
+    _onetree_min_size = size;
+    return SUCCESS;
+}
+
+int BoundComputator::GetOneTreeMinSize() const { return _onetree_min_size; }
+
+DualAscent *BoundComputator::GetDualAscent() const { return _dual_ascent; }
+
+const SubsetTable *BoundComputator::GetSubsetTable() const {
+    return _subset_table;
+}
+
+const MSTEngine *BoundComputator::GetMSTEngine() const { return _mst_engine; }
+
+const NearestTerminals *BoundComputator::GetNearestTerminals() const {
+    return _nearest_terminals;
 }
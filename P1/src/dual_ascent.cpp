@@ -0,0 +1,301 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * dual_ascent.cpp
+ *
+ *
+ * Implementation of functionality described in dual_ascent.hpp.
+ */
+
+#include "dual_ascent.hpp"
+
+#include <queue>
+#include <functional>
+#include <utility>
+
+using namespace std;
+
+DualAscent::DualAscent(Instance *problem_instance) {
+    _problem_instance = problem_instance;
+    _n_terminals = problem_instance->GetNTerminals();
+    _n_ids = problem_instance->GetIdBound();
+    _lower_bound = 0;
+
+    _terminal_index.assign(_n_ids, -1);
+    for (int t = 0; t < _n_terminals; t++)
+        _terminal_index[problem_instance->GetTerminals()[t]->GetId()] = t;
+
+    /* Create the arcs entering each vertex, ordered by head. */
+    const vector<Vertex*> &vertices = problem_instance->GetVertices();
+    vector<Vertex*> by_id(_n_ids, NULL);
+    for (unsigned int i = 0; i < vertices.size(); i++)
+        by_id[vertices[i]->GetId()] = vertices[i];
+
+    _in_begin.assign(_n_ids + 1, 0);
+    vector<int> n_out(_n_ids, 0);
+    for (int x = 0; x < _n_ids; x++) {
+        _in_begin[x] = _arc_tail.size();
+        if (by_id[x] == NULL)
+            continue;
+        const vector<Vertex*> &neighbours = by_id[x]->GetNeighbours();
+        for (unsigned int j = 0; j < neighbours.size(); j++) {
+            int u = neighbours[j]->GetId();
+            _arc_tail.push_back(u);
+            _arc_head.push_back(x);
+            _reduced_costs.push_back(RectDistance(neighbours[j], by_id[x]));
+            n_out[u]++;
+        }
+    }
+    _in_begin[_n_ids] = _arc_tail.size();
+
+    /* Find the arcs leaving each vertex. */
+    _out_begin.assign(_n_ids + 1, 0);
+    for (int u = 0; u < _n_ids; u++)
+        _out_begin[u + 1] = _out_begin[u] + n_out[u];
+    _out_arcs.resize(_arc_tail.size());
+    vector<int> fill(_out_begin.begin(), _out_begin.end() - 1);
+    for (unsigned int a = 0; a < _arc_tail.size(); a++)
+        _out_arcs[fill[_arc_tail[a]]++] = a;
+}
+
+Result DualAscent::Run() {
+    int root = _problem_instance->GetTerminals()[0]->GetId();
+    _prefix_sums.assign(_n_terminals, vector<int>(1, 0));
+    _segments.assign(_n_terminals, vector<DualSegment>());
+    _entries.assign((uint64_t) _n_terminals * _n_ids, DUAL_NOT_ENTERED);
+
+    /* Active terminals ordered by the size of their last component. */
+    typedef pair<int, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry> > active;
+    for (int t = 1; t < _n_terminals; t++)
+        active.push(make_pair(1, t));
+
+    /* W(t) as found when y_W(t) was last raised, and its terminals. */
+    vector<vector<int> > components(_n_terminals);
+    vector<uint64_t> masks(_n_terminals, 0);
+
+    vector<int> marks(_n_ids, -1);
+    vector<int> cut;
+    int n_searches = 0;
+    while (!active.empty()) {
+        int t = active.top().second;
+        active.pop();
+
+        /* W(t) only grows, so we search backwards along arcs of reduced
+         * cost 0 starting from its previous vertices, marking W(t) with
+         * the number of this search. Arcs entering W(t) are collected on
+         * the way, although their tails may still join W(t) later. */
+        vector<int> &component = components[t];
+        if (component.empty())
+            component.push_back(
+                _problem_instance->GetTerminals()[t]->GetId());
+        int mark = n_searches++;
+        int old_size = component.size();
+        for (int i = 0; i < old_size; i++)
+            marks[component[i]] = mark;
+        cut.clear();
+        for (unsigned int i = 0; i < component.size(); i++) {
+            int x = component[i];
+            for (int a = _in_begin[x]; a < _in_begin[x + 1]; a++) {
+                int u = _arc_tail[a];
+                if (marks[u] == mark)
+                    continue;
+                if (_reduced_costs[a] == 0) {
+                    marks[u] = mark;
+                    component.push_back(u);
+                }
+                else
+                    cut.push_back(a);
+            }
+        }
+        if (marks[root] == mark) {
+            vector<int>().swap(component);
+            continue;
+        }
+
+        /* Find the minimum reduced cost of an arc entering W(t). */
+        int delta = INT_MAX;
+        for (unsigned int i = 0; i < cut.size(); i++) {
+            int a = cut[i];
+            if (marks[_arc_tail[a]] != mark && _reduced_costs[a] < delta)
+                delta = _reduced_costs[a];
+        }
+        if (delta == INT_MAX)
+            continue;
+
+        /* Raise y_W(t) by delta. Only the vertices that joined W(t) since
+         * the last raise are new in the sets raised for t. */
+        int k = _prefix_sums[t].size() - 1;
+        int size = component.size();
+        for (int i = (k == 0) ? 0 : old_size; i < size; i++) {
+            int x = component[i];
+            _entries[t * _n_ids + x] = k;
+            if (_terminal_index[x] >= 0)
+                masks[t] |= (uint64_t) 1 << _terminal_index[x];
+        }
+        for (unsigned int i = 0; i < cut.size(); i++) {
+            int a = cut[i];
+            if (marks[_arc_tail[a]] != mark)
+                _reduced_costs[a] -= delta;
+        }
+        if (_segments[t].empty() || _segments[t].back()._mask != masks[t]) {
+            DualSegment segment = { k, masks[t] };
+            _segments[t].push_back(segment);
+        }
+        _prefix_sums[t].push_back(_prefix_sums[t].back() + delta);
+        _lower_bound += delta;
+
+        /* Raise the smallest component next. Its size is only updated
+         * when it is raised, which is much faster than searching it 
+         * again first and gives about the same bound. */
+        active.push(make_pair(size, t));
+    }
+
+    return ComputeDistances();
+}
+
+Result DualAscent::ComputeDistances() {
+    typedef pair<int, int> Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry> > queue;
+
+    /* d~(r, x), along arcs leaving the vertices. */
+    _root_distances.assign(_n_ids, INT_MAX);
+    int root = _problem_instance->GetTerminals()[0]->GetId();
+    _root_distances[root] = 0;
+    queue.push(make_pair(0, root));
+    while (!queue.empty()) {
+        int d = queue.top().first;
+        int u = queue.top().second;
+        queue.pop();
+        if (d > _root_distances[u])
+            continue;
+        for (int i = _out_begin[u]; i < _out_begin[u + 1]; i++) {
+            int a = _out_arcs[i];
+            int x = _arc_head[a];
+            if (d + _reduced_costs[a] < _root_distances[x]) {
+                _root_distances[x] = d + _reduced_costs[a];
+                queue.push(make_pair(_root_distances[x], x));
+            }
+        }
+    }
+
+    /* d~(x, R), along arcs entering the vertices. */
+    _terminal_distances.assign(_n_ids, INT_MAX);
+    for (int t = 0; t < _n_terminals; t++) {
+        int id = _problem_instance->GetTerminals()[t]->GetId();
+        _terminal_distances[id] = 0;
+        queue.push(make_pair(0, id));
+    }
+    while (!queue.empty()) {
+        int d = queue.top().first;
+        int x = queue.top().second;
+        queue.pop();
+        if (d > _terminal_distances[x])
+            continue;
+        for (int a = _in_begin[x]; a < _in_begin[x + 1]; a++) {
+            int u = _arc_tail[a];
+            if (d + _reduced_costs[a] < _terminal_distances[u]) {
+                _terminal_distances[u] = d + _reduced_costs[a];
+                queue.push(make_pair(_terminal_distances[u], u));
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+int DualAscent::GetLowerBound() const { return _lower_bound; }
+
+int DualAscent::LabelLowerBound(Vertex *v, uint64_t I) const {
+    int id = v->GetId();
+    int sum = 0;
+    for (uint64_t J = I; J != 0; J &= J - 1) {
+        int t = __builtin_ctzll(J);
+
+        /* The sets raised for t whose terminals are all in I are
+         * a prefix of them. */
+        const vector<DualSegment> &segments = _segments[t];
+        int k = _prefix_sums[t].size() - 1;
+        for (unsigned int i = 0; i < segments.size(); i++) {
+            if (segments[i]._mask & ~I) {
+                k = segments[i]._begin;
+                break;
+            }
+        }
+        int entry = _entries[t * _n_ids + id];
+        if (entry < k)
+            k = entry;
+        sum += _prefix_sums[t][k];
+    }
+    return _root_distances[id] + _lower_bound - sum;
+}
+
+Result DualAscent::EliminateVertices(int upper_bound, int &ret_n_vertices,
+                                     int &ret_n_edges) {
+    ret_n_vertices = 0;
+    ret_n_edges = 0;
+    const vector<Vertex*> &vertices = _problem_instance->GetVertices();
+    vector<bool> removed(_problem_instance->GetIdBound(), false);
+    bool any_removed = false;
+
+    for (unsigned int i = 0; i < vertices.size(); i++) {
+        Vertex *v = vertices[i];
+        int id = v->GetId();
+        if (_terminal_index[id] < 0 &&
+            (int64_t) _lower_bound + _root_distances[id] +
+                _terminal_distances[id] > upper_bound) {
+            removed[id] = true;
+            any_removed = true;
+        }
+    }
+
+    /* An edge can be removed if neither of its arcs is needed. Edges
+     * created by removing vertices of low degree have no arcs, and are
+     * kept. */
+    vector<pair<Vertex*, Vertex*> > edges;
+    for (unsigned int i = 0; i < vertices.size(); i++) {
+        Vertex *u = vertices[i];
+        int u_id = u->GetId();
+        if (removed[u_id])
+            continue;
+        for (int j = _out_begin[u_id]; j < _out_begin[u_id + 1]; j++) {
+            int a = _out_arcs[j];
+            int w_id = _arc_head[a];
+            if (w_id < u_id || removed[w_id])
+                continue;
+            int64_t lb = (int64_t) _lower_bound + _root_distances[u_id] +
+                         _reduced_costs[a] + _terminal_distances[w_id];
+            if (lb <= upper_bound)
+                continue;
+
+            /* Find the opposite arc, which enters u. */
+            for (int b = _in_begin[u_id]; b < _in_begin[u_id + 1]; b++) {
+                if (_arc_tail[b] != w_id)
+                    continue;
+                int64_t lb_back = (int64_t) _lower_bound +
+                                  _root_distances[w_id] +
+                                  _reduced_costs[b] +
+                                  _terminal_distances[u_id];
+                if (lb_back > upper_bound) {
+                    for (unsigned int k = 0; k < u->GetNeighbours().size();
+                         k++) {
+                        Vertex *w = u->GetNeighbours()[k];
+                        if (w->GetId() == w_id)
+                            edges.push_back(make_pair(u, w));
+                    }
+                }
+            }
+        }
+    }
+    for (unsigned int i = 0; i < edges.size(); i++) {
+        edges[i].first->RemoveNeighbour(edges[i].second);
+        edges[i].second->RemoveNeighbour(edges[i].first);
+    }
+    ret_n_edges = edges.size();
+
+    if (!any_removed && edges.empty())
+        return SUCCESS;
+    return _problem_instance->RemoveVertices(removed, ret_n_vertices);
+}
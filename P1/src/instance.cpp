@@ -12,6 +12,10 @@
 
 #include "instance.hpp"
 
+#include <algorithm>
+#include <queue>
+#include <functional>
+
 using namespace std;
 
 Result Instance::SetXYZ(int **term_locs) {
@@ -129,7 +133,7 @@ Result Instance::SortTerminals() {
 }
 
 Result Instance::SetIds() {
-    for (int i = 0; i < _n_terminals; i++) {
+    for (int i = 0; i < _n_vertices; i++) {
         _V[i]->SetId(i);
     }
     return SUCCESS;
@@ -141,6 +145,7 @@ Instance::Instance(int n, int **term_locs) {
     
     SetVertices();
     _n_vertices = _V.size();
+    _n_hanan_vertices = _n_vertices;
 
     SetHananGrid();
     SetNeighbours();
@@ -151,6 +156,296 @@ Instance::Instance(int n, int **term_locs) {
     SetIds();
 }
 
+Result Instance::MarkEmptyCorners(vector<bool> &ret_removed) {
+    const set<int> *values[3] = { &_x_values, &_y_values, &_z_values };
+    int n_values[3] = { _n_x_values, _n_y_values, _n_z_values };
+
+    /* Positions of the terminals in the Hanan grid along each axis. */
+    vector<int> term_pos[3];
+    for (int a = 0; a < 3; a++) {
+        vector<int> sorted(values[a]->begin(), values[a]->end());
+        for (int t = 0; t < _n_terminals; t++) {
+            int coord = (a == 0) ? _terminals[t]->GetX() :
+                        (a == 1) ? _terminals[t]->GetY() : 
+                                   _terminals[t]->GetZ();
+            term_pos[a].push_back(lower_bound(sorted.begin(), sorted.end(), 
+                                              coord) - sorted.begin());
+        }
+    }
+
+    /* For each coordinate plane (a, b) and each of the four corners of
+     * the plane (bit 0 / 1 set if the corner is at the upper end of axis
+     * a / b), find the positions in the plane whose quadrant towards 
+     * the corner contains the projection of a terminal. We do so by 
+     * walking the plane away from the corner. */
+    const int planes[3][2] = { {0, 1}, {0, 2}, {1, 2} };
+    vector<bool> has_terminal[3][4];
+    for (int p = 0; p < 3; p++) {
+        int a = planes[p][0], b = planes[p][1];
+        int n_a = n_values[a], n_b = n_values[b];
+
+        vector<bool> occupied(n_a * n_b, false);
+        for (int t = 0; t < _n_terminals; t++)
+            occupied[term_pos[a][t] * n_b + term_pos[b][t]] = true;
+
+        for (int corner = 0; corner < 4; corner++) {
+            int step_a = (corner & 1) ? -1 : 1;
+            int step_b = (corner & 2) ? -1 : 1;
+            vector<bool> &found = has_terminal[p][corner];
+            found.resize(n_a * n_b);
+            for (int s = 0; s < n_a; s++) {
+                int i = (step_a > 0) ? s : n_a - 1 - s;
+                for (int r = 0; r < n_b; r++) {
+                    int j = (step_b > 0) ? r : n_b - 1 - r;
+                    found[i * n_b + j] = occupied[i * n_b + j] ||
+                        (s > 0 && found[(i - step_a) * n_b + j]) ||
+                        (r > 0 && found[i * n_b + j - step_b]);
+                }
+            }
+        }
+    }
+
+    /* Only empty quadrants towards the same corner of the bounding box 
+     * (bit a set if it is at the upper end of axis a) may be combined, 
+     * so we pick the corner for which most vertices are removed. */
+    int best_count = -1;
+    vector<bool> removed(_n_vertices);
+    for (int corner = 0; corner < 8; corner++) {
+        int count = 0;
+        for (int i = 0; i < _n_x_values; i++) {
+            for (int j = 0; j < _n_y_values; j++) {
+                for (int k = 0; k < _n_z_values; k++) {
+                    int pos[3] = { i, j, k };
+                    bool empty = false;
+                    for (int p = 0; p < 3; p++) {
+                        int a = planes[p][0], b = planes[p][1];
+                        int plane_corner = ((corner >> a) & 1) | 
+                                           (((corner >> b) & 1) << 1);
+                        if (!has_terminal[p][plane_corner]
+                                [pos[a] * n_values[b] + pos[b]])
+                            empty = true;
+                    }
+                    removed[_hanan_grid[i][j][k]->GetId()] = empty;
+                    count += empty;
+                }
+            }
+        }
+        if (count > best_count) {
+            best_count = count;
+            ret_removed = removed;
+        }
+    }
+    return SUCCESS;
+}
+
+Result Instance::RemoveLowDegreeVertices(vector<bool> &removed) {
+    int n_ids = GetIdBound();
+    vector<bool> is_terminal(n_ids, false);
+    for (int t = 0; t < _n_terminals; t++)
+        is_terminal[_terminals[t]->GetId()] = true;
+
+    /* Disconnect the vertices that are already marked. */
+    for (int i = 0; i < _n_vertices; i++) {
+        if (!removed[_V[i]->GetId()])
+            continue;
+        vector<Vertex*> neighbours = _V[i]->GetNeighbours();
+        for (unsigned int j = 0; j < neighbours.size(); j++) {
+            neighbours[j]->RemoveNeighbour(_V[i]);
+            _V[i]->RemoveNeighbour(neighbours[j]);
+        }
+    }
+
+    vector<Vertex*> by_id(n_ids, NULL);
+    vector<int> stack;
+    for (int i = 0; i < _n_vertices; i++) {
+        int id = _V[i]->GetId();
+        by_id[id] = _V[i];
+        if (!removed[id] && !is_terminal[id])
+            stack.push_back(id);
+    }
+    while (!stack.empty()) {
+        int i = stack.back();
+        stack.pop_back();
+        Vertex *v = by_id[i];
+        if (removed[i] || v->GetNNeighbours() > 2)
+            continue;
+
+        /* Connect the two neighbours u, w of v directly, unless they 
+         * already are, and disconnect v. Since the length of an edge is
+         * the distance between its ends, this is only possible if the 
+         * path u, v, w is a shortest path. */
+        vector<Vertex*> neighbours = v->GetNeighbours();
+        if (neighbours.size() == 2 && 
+            !neighbours[0]->HasNeighbour(neighbours[1])) {
+            Vertex *u = neighbours[0], *w = neighbours[1];
+            if (RectDistance(u, w) < RectDistance(u, v) + RectDistance(v, w))
+                continue;
+            u->ReplaceNeighbour(v, w);
+            w->ReplaceNeighbour(v, u);
+        }
+        else {
+            for (unsigned int j = 0; j < neighbours.size(); j++)
+                neighbours[j]->RemoveNeighbour(v);
+        }
+        removed[i] = true;
+
+        /* The neighbours of v may now have fewer neighbours. */
+        for (unsigned int j = 0; j < neighbours.size(); j++) {
+            int id = neighbours[j]->GetId();
+            if (!removed[id] && !is_terminal[id])
+                stack.push_back(id);
+        }
+    }
+    return SUCCESS;
+}
+
+Result Instance::ReduceHananGrid(int &ret_n_removed) {
+    vector<bool> removed(_n_vertices, false);
+    MarkEmptyCorners(removed);
+    RemoveLowDegreeVertices(removed);
+
+    /* Delete the removed vertices and assign new IDs to the others. */
+    int n_vertices = _n_vertices;
+    DeleteVertices(removed);
+    ret_n_removed = n_vertices - _n_vertices;
+    for (int i = 0; i < _n_vertices; i++)
+        _V[i]->ResetId();
+    SetIds();
+    return SUCCESS;
+}
+
+Result Instance::DeleteVertices(const vector<bool> &removed) {
+    for (int i = 0; i < _n_x_values; i++) {
+        for (int j = 0; j < _n_y_values; j++) {
+            for (int k = 0; k < _n_z_values; k++) {
+                Vertex *v = _hanan_grid[i][j][k];
+                if (v != NULL && removed[v->GetId()])
+                    _hanan_grid[i][j][k] = NULL;
+            }
+        }
+    }
+    vector<Vertex*> remaining;
+    for (int i = 0; i < _n_vertices; i++) {
+        if (removed[_V[i]->GetId()])
+            delete _V[i];
+        else
+            remaining.push_back(_V[i]);
+    }
+    _V.swap(remaining);
+    _n_vertices = _V.size();
+    return SUCCESS;
+}
+
+int Instance::GetIdBound() const {
+    int n_ids = 0;
+    for (int i = 0; i < _n_vertices; i++)
+        n_ids = max(n_ids, _V[i]->GetId() + 1);
+    return n_ids;
+}
+
+Result Instance::TwoNearestTerminals(vector<int> &ret_base,
+                                     vector<int> &ret_dist,
+                                     vector<int> &ret_snd_dist) const {
+    int n_ids = GetIdBound();
+    ret_base.assign(n_ids, -1);
+    ret_dist.assign(n_ids, INT_MAX);
+    ret_snd_dist.assign(n_ids, INT_MAX);
+
+    /* Entries are (distance, (terminal, vertex)). A vertex is done once
+     * it has been reached from two different terminals. */
+    typedef pair<int, pair<int, Vertex*> > Entry;
+    priority_queue<Entry, vector<Entry>, greater<Entry> > queue;
+    for (int t = 0; t < _n_terminals; t++)
+        queue.push(make_pair(0, make_pair(t, _terminals[t])));
+
+    while (!queue.empty()) {
+        int d = queue.top().first;
+        int t = queue.top().second.first;
+        Vertex *v = queue.top().second.second;
+        queue.pop();
+
+        int id = v->GetId();
+        if (ret_snd_dist[id] != INT_MAX || ret_base[id] == t)
+            continue;
+        if (ret_base[id] < 0) {
+            ret_base[id] = t;
+            ret_dist[id] = d;
+        }
+        else
+            ret_snd_dist[id] = d;
+
+        const vector<Vertex*> &neighbours = v->GetNeighbours();
+        for (unsigned int j = 0; j < neighbours.size(); j++) {
+            Vertex *w = neighbours[j];
+            int w_id = w->GetId();
+            if (ret_snd_dist[w_id] == INT_MAX && ret_base[w_id] != t)
+                queue.push(make_pair(d + RectDistance(v, w), 
+                                     make_pair(t, w)));
+        }
+    }
+    return SUCCESS;
+}
+
+Result Instance::EliminateVertices(int upper_bound, int &ret_n_removed) {
+    ret_n_removed = 0;
+    if (_n_terminals < 2)
+        return SUCCESS;
+
+    vector<int> base, dist, snd_dist;
+    TwoNearestTerminals(base, dist, snd_dist);
+
+    /* The radius of a terminal z is the minimum of d(z, u) + c(u, w) 
+     * over all edges (u, w) leaving its Voronoi region. */
+    vector<int64_t> radius(_n_terminals, INT_MAX);
+    for (int i = 0; i < _n_vertices; i++) {
+        Vertex *u = _V[i];
+        int z = base[u->GetId()];
+        if (z < 0)
+            continue;
+        const vector<Vertex*> &neighbours = u->GetNeighbours();
+        for (unsigned int j = 0; j < neighbours.size(); j++) {
+            Vertex *w = neighbours[j];
+            if (base[w->GetId()] != z)
+                radius[z] = min(radius[z], (int64_t) dist[u->GetId()] + 
+                                           RectDistance(u, w));
+        }
+    }
+    sort(radius.begin(), radius.end());
+    int64_t radius_sum = 0;
+    for (int i = 0; i < _n_terminals - 2; i++)
+        radius_sum += radius[i];
+
+    int n_ids = GetIdBound();
+    vector<bool> is_terminal(n_ids, false);
+    for (int t = 0; t < _n_terminals; t++)
+        is_terminal[_terminals[t]->GetId()] = true;
+
+    /* A vertex that cannot reach two terminals is in no tree either. */
+    vector<bool> removed(n_ids, false);
+    bool any_removed = false;
+    for (int i = 0; i < _n_vertices; i++) {
+        int id = _V[i]->GetId();
+        if (is_terminal[id])
+            continue;
+        if (snd_dist[id] == INT_MAX || 
+            radius_sum + dist[id] + snd_dist[id] > upper_bound) {
+            removed[id] = true;
+            any_removed = true;
+        }
+    }
+    if (!any_removed)
+        return SUCCESS;
+    return RemoveVertices(removed, ret_n_removed);
+}
+
+Result Instance::RemoveVertices(vector<bool> &removed, int &ret_n_removed) {
+    RemoveLowDegreeVertices(removed);
+    int n_vertices = _n_vertices;
+    DeleteVertices(removed);
+    ret_n_removed = n_vertices - _n_vertices;
+    return SUCCESS;
+}
+
 Instance::~Instance() {
     /* Delete all vertices */
     for (int i = 0; i < _n_vertices; i++) {
@@ -172,6 +467,8 @@ const int &Instance::GetNTerminals() const { return _n_terminals; }
 
 const int &Instance::GetNVertices() const { return _n_vertices; }
 
+const int &Instance::GetNHananVertices() const { return _n_hanan_vertices; }
+
 const vector<Vertex*> &Instance::GetVertices() const { return _V; }
 
 Vertex **Instance::GetTerminals() const { return _terminals; }
@@ -14,13 +14,19 @@
 
 using namespace std;
 
-Label::Label(Vertex *v, const bitset<BITSET_SIZE> &I) {
+Label::Label(Vertex *v, const bitset<BITSET_SIZE> &I, unsigned int index) {
     _v = v;
     _I = I;
+    _index = index;
+    _predecessor = LABEL_NO_PREDECESSOR;
+    _queue_key = -1;
+    _queue_pos = 0;
 
     _l_set = false;
     _in_P = false;
     _lower_bound_set = false;
+    _lower_bound_refined = false;
+    _retired = false;
 }
 
 int Label::GetL() const {
@@ -45,12 +51,20 @@ bool Label::IsLSet() const { return _l_set; }
 
 bool Label::IsLowerBoundSet() const { return _lower_bound_set; }
 
+bool Label::IsLowerBoundRefined() const { return _lower_bound_refined; }
+
 bool Label::IsInP() const { return _in_P; }
 
+bool Label::IsRetired() const { return _retired; }
+
 Vertex *Label::GetVertex() const { return _v; }
 
 const bitset<BITSET_SIZE> &Label::GetBitset() const { return _I; }
 
+unsigned int Label::GetIndex() const { return _index; }
+
+unsigned int Label::GetPredecessor() const { return _predecessor; }
+
 
 Result Label::SetL(int l) {
     _l_set = true;
@@ -58,12 +72,23 @@ Result Label::SetL(int l) {
     return SUCCESS;
 }
 
+Result Label::SetPredecessor(unsigned int predecessor) {
+    _predecessor = predecessor;
+    return SUCCESS;
+}
+
 Result Label::SetLowerBound(int l) {
     _lower_bound_set = true;
     _lower_bound = l;
     return SUCCESS;
 }
 
+Result Label::RefineLowerBound(int l) {
+    _lower_bound_refined = true;
+    _lower_bound = l;
+    return SUCCESS;
+}
+
 Result Label::SetInP() {
     if (!_in_P) {
         _in_P = true; 
@@ -74,6 +99,23 @@ Result Label::SetInP() {
     }
 }
 
+Result Label::Retire() {
+    if (_in_P || _retired)
+        return FAIL;
+    _retired = true;
+    return SUCCESS;
+}
+
+int Label::GetQueueKey() const { return _queue_key; }
+
+unsigned int Label::GetQueuePos() const { return _queue_pos; }
+
+Result Label::SetQueuePosition(int key, unsigned int pos) {
+    _queue_key = key;
+    _queue_pos = pos;
+    return SUCCESS;
+}
+
 void Label::Print() const {
     cout << "Vertex: \n";
     _v->Print();
@@ -0,0 +1,100 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * label_queue.cpp
+ *
+ *
+ * Implementation of functionality described in label_queue.hpp.
+ */
+
+#include "label_queue.hpp"
+
+using namespace std;
+
+Result HeapLabelQueue::Push(Label *l, int key) {
+    _heap.push(make_pair(key, l));
+    return SUCCESS;
+}
+
+Label *HeapLabelQueue::Pop() {
+    if (_heap.empty())
+        return NULL;
+    Label *l = _heap.top().second;
+    _heap.pop();
+    return l;
+}
+
+int HeapLabelQueue::GetMinKey() {
+    if (_heap.empty())
+        return -1;
+    return _heap.top().first;
+}
+
+uint64_t HeapLabelQueue::GetSize() const { return _heap.size(); }
+
+BucketLabelQueue::BucketLabelQueue(int max_key) {
+    _max_key = max_key;
+    _buckets.resize(max_key + 1);
+    _cursor = max_key + 1;
+    _size = 0;
+}
+
+Result BucketLabelQueue::RemoveFromBucket(Label *l) {
+    /* Move the last label in the bucket to the position of l. */
+    vector<Label*> &bucket = _buckets[l->GetQueueKey()];
+    Label *last = bucket.back();
+    bucket[l->GetQueuePos()] = last;
+    last->SetQueuePosition(last->GetQueueKey(), l->GetQueuePos());
+    bucket.pop_back();
+
+    l->SetQueuePosition(-1, 0);
+    _size --;
+    return SUCCESS;
+}
+
+Result BucketLabelQueue::Push(Label *l, int key) {
+    if (l->GetQueueKey() >= 0) {
+        if (l->GetQueueKey() == key)
+            return SUCCESS;
+        RemoveFromBucket(l);
+    }
+
+    /* Labels with a key exceeding the maximum key are never popped
+     * before the solution is found, so we do not store them. */
+    if (key > _max_key)
+        return FAIL;
+
+    l->SetQueuePosition(key, _buckets[key].size());
+    _buckets[key].push_back(l);
+    _size ++;
+
+    /* Keys are usually pushed in monotone order, but we do not rely
+     * on this. */
+    if (key < _cursor)
+        _cursor = key;
+    return SUCCESS;
+}
+
+int BucketLabelQueue::GetMinKey() {
+    while (_cursor <= _max_key && _buckets[_cursor].empty())
+        _cursor ++;
+    if (_cursor > _max_key)
+        return -1;
+    return _cursor;
+}
+
+Label *BucketLabelQueue::Pop() {
+    if (GetMinKey() < 0)
+        return NULL;
+
+    Label *l = _buckets[_cursor].back();
+    _buckets[_cursor].pop_back();
+    l->SetQueuePosition(-1, 0);
+    _size --;
+    return l;
+}
+
+uint64_t BucketLabelQueue::GetSize() const { return _size; }
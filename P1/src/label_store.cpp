@@ -0,0 +1,68 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * label_store.cpp
+ *
+ *
+ * Implementation of functionality described in label_store.hpp.
+ */
+
+#include "label_store.hpp"
+
+#include <new>
+
+using namespace std;
+
+LabelStore::LabelStore() {
+    _n_used_in_slab = LABEL_SLAB_SIZE;
+    _n_labels = 0;
+}
+
+LabelStore::~LabelStore() {
+    /* Labels do not own any memory themselves, so we can
+     * simply free the slabs. */
+    for (unsigned int i = 0; i < _slabs.size(); i++)
+        free(_slabs[i]);
+}
+
+Result LabelStore::AddSlab() {
+    Label *slab = (Label*) malloc(LABEL_SLAB_SIZE * sizeof(Label));
+    if (slab == NULL) {
+        cout << "ERROR: Failed to allocate memory for labels.\n";
+        exit(1);
+    }
+    _slabs.push_back(slab);
+    _n_used_in_slab = 0;
+    return SUCCESS;
+}
+
+Label *LabelStore::NewLabel(Vertex *v, const bitset<BITSET_SIZE> &I) {
+    unsigned int index;
+
+    /* Reuse a released label if there is one, otherwise take
+     * the next unused label from the last slab. */
+    if (!_free_labels.empty()) {
+        index = _free_labels.back();
+        _free_labels.pop_back();
+    }
+    else {
+        if (_n_used_in_slab == LABEL_SLAB_SIZE)
+            AddSlab();
+        index = ((_slabs.size() - 1) << LABEL_SLAB_BITS) + _n_used_in_slab;
+        _n_used_in_slab ++;
+    }
+
+    _n_labels ++;
+    return new (GetLabel(index)) Label(v, I, index);
+}
+
+Result LabelStore::ReleaseLabel(Label *l) {
+    _free_labels.push_back(l->GetIndex());
+    _n_labels --;
+    return SUCCESS;
+}
+
+long LabelStore::GetNLabels() const { return _n_labels; }
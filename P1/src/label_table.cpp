@@ -0,0 +1,137 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * label_table.cpp
+ *
+ *
+ * Implementation of functionality described in label_table.hpp.
+ */
+
+#include "label_table.hpp"
+
+using namespace std;
+
+LabelTable::LabelTable(LabelStore *label_store, uint64_t expected_n_labels) {
+    _label_store = label_store;
+    _n_entries = 0;
+
+    /* Choose the smallest power of two for which the expected number of
+     * labels fits without exceeding the maximum load. */
+    _capacity = LABEL_TABLE_MIN_CAPACITY;
+    while (_capacity < LABEL_TABLE_MAX_INIT_CAPACITY &&
+           _capacity * LABEL_TABLE_MAX_LOAD < expected_n_labels * 100)
+        _capacity *= 2;
+
+    _entries = (LabelTableEntry*) malloc(_capacity * sizeof(LabelTableEntry));
+    if (_entries == NULL) {
+        cout << "ERROR: Failed to allocate memory for label table.\n";
+        exit(1);
+    }
+    for (uint64_t i = 0; i < _capacity; i++)
+        _entries[i]._vertex = -1;
+}
+
+LabelTable::~LabelTable() {
+    free(_entries);
+}
+
+uint64_t LabelTable::Hash(int vertex, uint64_t I) const {
+    uint64_t h = I ^ ((uint64_t) vertex * 0x9e3779b97f4a7c15ULL);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h & (_capacity - 1);
+}
+
+Result LabelTable::InsertEntry(const LabelTableEntry &entry) {
+    uint64_t pos = Hash(entry._vertex, entry._mask);
+    while (_entries[pos]._vertex >= 0)
+        pos = (pos + 1) & (_capacity - 1);
+    _entries[pos] = entry;
+    return SUCCESS;
+}
+
+Result LabelTable::Grow() {
+    LabelTableEntry *old_entries = _entries;
+    uint64_t old_capacity = _capacity;
+
+    _capacity *= 2;
+    _entries = (LabelTableEntry*) malloc(_capacity * sizeof(LabelTableEntry));
+    if (_entries == NULL) {
+        cout << "ERROR: Failed to allocate memory for label table.\n";
+        exit(1);
+    }
+    for (uint64_t i = 0; i < _capacity; i++)
+        _entries[i]._vertex = -1;
+
+    for (uint64_t i = 0; i < old_capacity; i++) {
+        if (old_entries[i]._vertex >= 0)
+            InsertEntry(old_entries[i]);
+    }
+    free(old_entries);
+    return SUCCESS;
+}
+
+Result LabelTable::AddLabel(Label *l) {
+    if ((_n_entries + 1) * 100 > _capacity * LABEL_TABLE_MAX_LOAD)
+        Grow();
+
+    LabelTableEntry entry;
+    entry._mask = l->GetBitset().to_ullong();
+    entry._vertex = l->GetVertex()->GetId();
+    entry._label = l->GetIndex();
+    InsertEntry(entry);
+
+    _n_entries ++;
+    return SUCCESS;
+}
+
+Result LabelTable::RemoveLabel(Label *l) {
+    uint64_t mask = l->GetBitset().to_ullong();
+    int vertex = l->GetVertex()->GetId();
+    uint64_t pos = Hash(vertex, mask);
+    while (_entries[pos]._vertex >= 0 && 
+           (_entries[pos]._vertex != vertex || _entries[pos]._mask != mask))
+        pos = (pos + 1) & (_capacity - 1);
+    if (_entries[pos]._vertex < 0)
+        return FAIL;
+
+    /* An entry after the gap may be moved into it if probing for it 
+     * starts at or before the gap. */
+    uint64_t gap = pos;
+    for (uint64_t i = (gap + 1) & (_capacity - 1); _entries[i]._vertex >= 0;
+         i = (i + 1) & (_capacity - 1)) {
+        uint64_t start = Hash(_entries[i]._vertex, _entries[i]._mask);
+        if (((i - start) & (_capacity - 1)) >= ((i - gap) & (_capacity - 1))) {
+            _entries[gap] = _entries[i];
+            gap = i;
+        }
+    }
+    _entries[gap]._vertex = -1;
+    _n_entries --;
+    return SUCCESS;
+}
+
+Label *LabelTable::GetLabel(int vertex, const bitset<BITSET_SIZE> &I) const {
+    uint64_t mask = I.to_ullong();
+    uint64_t pos = Hash(vertex, mask);
+
+    /* Probe until we either find the label or hit an empty entry. */
+    while (_entries[pos]._vertex >= 0) {
+        if (_entries[pos]._vertex == vertex && _entries[pos]._mask == mask)
+            return _label_store->GetLabel(_entries[pos]._label);
+        pos = (pos + 1) & (_capacity - 1);
+    }
+    return NULL;
+}
+
+uint64_t LabelTable::GetNLabels() const { return _n_entries; }
+
+uint64_t LabelTable::GetMemoryUsage() const {
+    return _capacity * sizeof(LabelTableEntry);
+}
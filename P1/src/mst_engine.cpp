@@ -0,0 +1,148 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * mst_engine.cpp
+ *
+ *
+ * Implementation of functionality described in mst_engine.hpp.
+ */
+
+#include "mst_engine.hpp"
+
+#include <string.h>
+
+using namespace std;
+
+MSTEngine::MSTEngine(const int32_t *xs, const int32_t *ys, 
+                     const int32_t *zs, int n) {
+    _n_terminals = n;
+    _terminal_mask = (n == 64) ? ~(uint64_t) 0 : ((uint64_t) 1 << n) - 1;
+    _row_size = ((n + SIMD_PAD - 1) / SIMD_PAD) * SIMD_PAD;
+    _n_computed = 0;
+    _n_derived = 0;
+
+    /* Row i of the matrix contains the distances from terminal i to 
+     * all terminals. */
+    _distances = (int32_t*) aligned_alloc(SIMD_ALIGN, 
+                    (size_t) n * _row_size * sizeof(int32_t));
+    for (int i = 0; i < n; i++)
+        RectDistances(xs, ys, zs, _row_size, xs[i], ys[i], zs[i], 
+                      _distances + i * _row_size);
+}
+
+MSTEngine::~MSTEngine() {
+    free(_distances);
+}
+
+int MSTEngine::Prim(uint64_t C, uint8_t *ret_parents) const {
+    if (ret_parents != NULL)
+        memset(ret_parents, MST_NO_PARENT, _n_terminals);
+
+    /* An MST on <= 1 vertex has length 0. */
+    if (__builtin_popcountll(C) <= 1)
+        return 0;
+
+    /* Cheapest cost of a connection to each terminal, and the terminal
+     * in the tree attaining it. Initially we add the first terminal to
+     * the tree. The terminals still to be added are those in remaining. */
+    alignas(SIMD_ALIGN) int32_t costs[BITSET_SIZE];
+    uint8_t closest[BITSET_SIZE];
+    int index = __builtin_ctzll(C);
+    uint64_t remaining = C & (C - 1);
+    memcpy(costs, GetDistances(index), _row_size * sizeof(int32_t));
+    memset(closest, index, _n_terminals);
+
+    int tree_cost = 0;
+    while (remaining != 0) {
+        /* Find terminal with minimum cost and add it to tree. */
+        int cost = MaskedMin(costs, remaining, index);
+        tree_cost += cost;
+        remaining &= ~((uint64_t) 1 << index);
+        if (ret_parents != NULL)
+            ret_parents[index] = closest[index];
+
+        /* Update terminal costs. */
+        const int32_t *row = GetDistances(index);
+        for (int i = 0; i < _n_terminals; i++) {
+            if (row[i] < costs[i]) {
+                costs[i] = row[i];
+                closest[i] = index;
+            }
+        }
+    }
+    return tree_cost;
+}
+
+int MSTEngine::RemoveLeaf(uint64_t C, int t, uint8_t *ret_parents) const {
+    auto it = _cache.find(C | ((uint64_t) 1 << t));
+    if (it == _cache.end())
+        return -1;
+    const uint8_t *parents = _parents.data() + 
+                             (size_t) it->second * _n_terminals;
+
+    /* Find the neighbours of t in the tree. */
+    int n_children = 0;
+    int child = -1;
+    for (uint64_t rest = C; rest != 0; rest &= rest - 1) {
+        int i = __builtin_ctzll(rest);
+        if (parents[i] == t) {
+            n_children ++;
+            child = i;
+        }
+    }
+
+    /* t is a leaf if it has a parent and no children, or if it is the 
+     * root and has exactly one child, which then becomes the root. */
+    int neighbour;
+    memcpy(ret_parents, parents, _n_terminals);
+    ret_parents[t] = MST_NO_PARENT;
+    if (parents[t] != MST_NO_PARENT && n_children == 0)
+        neighbour = parents[t];
+    else if (parents[t] == MST_NO_PARENT && n_children == 1) {
+        neighbour = child;
+        ret_parents[child] = MST_NO_PARENT;
+    }
+    else
+        return -1;
+
+    return _lengths[it->second] - GetDistances(t)[neighbour];
+}
+
+int MSTEngine::ComputeMST(uint64_t C) const {
+    return Prim(C & _terminal_mask, NULL);
+}
+
+int MSTEngine::GetMST(uint64_t C) {
+    C &= _terminal_mask;
+    auto it = _cache.find(C);
+    if (it != _cache.end())
+        return _lengths[it->second];
+
+    /* Room for the new tree. */
+    unsigned int pos = _lengths.size();
+    _parents.resize(_parents.size() + _n_terminals);
+    uint8_t *parents = _parents.data() + (size_t) pos * _n_terminals;
+
+    /* Try to remove a terminal not in C from a cached MST, and compute
+     * the MST otherwise. */
+    int length = -1;
+    uint64_t not_in_C = ~C & _terminal_mask;
+    for (; not_in_C != 0 && length < 0; not_in_C &= not_in_C - 1)
+        length = RemoveLeaf(C, __builtin_ctzll(not_in_C), parents);
+    if (length >= 0)
+        _n_derived ++;
+    else {
+        length = Prim(C, parents);
+        _n_computed ++;
+    }
+
+    _lengths.push_back(length);
+    _cache.insert(make_pair(C, pos));
+    return length;
+}
+
+uint64_t MSTEngine::GetNComputed() const { return _n_computed; }
+uint64_t MSTEngine::GetNDerived() const { return _n_derived; }
@@ -0,0 +1,90 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * nearest_terminals.cpp
+ *
+ *
+ * Implementation of functionality described in nearest_terminals.hpp.
+ */
+
+#include "nearest_terminals.hpp"
+#include "vertex.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+NearestTerminals::NearestTerminals(const int32_t *xs, const int32_t *ys,
+                                   const int32_t *zs, int n_terminals,
+                                   const vector<Vertex*> &vertices,
+                                   NearestMode mode, uint64_t max_memory) {
+    _n_terminals = n_terminals;
+    _terminal_x = xs;
+    _terminal_y = ys;
+    _terminal_z = zs;
+    _max_lists = max_memory / n_terminals;
+    _offsets.assign(vertices.size(), NEAREST_NOT_BUILT);
+
+    if (mode == NEAREST_EAGER) {
+        _lists.reserve(min((uint64_t) vertices.size(), _max_lists) * 
+                       n_terminals);
+        for (unsigned int i = 0; i < vertices.size(); i++)
+            BuildList(vertices[i]);
+    }
+}
+
+uint32_t NearestTerminals::BuildList(Vertex *v) {
+    if (_lists.size() / _n_terminals >= _max_lists)
+        return NEAREST_NOT_BUILT;
+
+    alignas(SIMD_ALIGN) int32_t dists[BITSET_SIZE];
+    RectDistances(_terminal_x, _terminal_y, _terminal_z, _n_terminals,
+                  v->GetX(), v->GetY(), v->GetZ(), dists);
+
+    /* Sort the terminals by distance, and by index among terminals at
+     * the same distance. */
+    uint8_t order[BITSET_SIZE];
+    for (int i = 0; i < _n_terminals; i++)
+        order[i] = i;
+    stable_sort(order, order + _n_terminals, [&](uint8_t i, uint8_t j) {
+        return dists[i] < dists[j];
+    });
+
+    uint32_t offset = _lists.size();
+    _lists.insert(_lists.end(), order, order + _n_terminals);
+    _offsets[v->GetId()] = offset;
+    return offset;
+}
+
+Result NearestTerminals::GetNearest(Vertex *v, uint64_t I, int &ret_dist,
+                                    int &ret_ind) {
+    uint32_t offset = _offsets[v->GetId()];
+    if (offset == NEAREST_NOT_BUILT && 
+        (offset = BuildList(v)) == NEAREST_NOT_BUILT)
+        return FAIL;
+
+    /* Walk the list until the first terminal not in I. */
+    const uint8_t *list = _lists.data() + offset;
+    for (int k = 0; k < _n_terminals; k++) {
+        int i = list[k];
+        if (!((I >> i) & 1)) {
+            ret_dist = abs(_terminal_x[i] - v->GetX()) + 
+                       abs(_terminal_y[i] - v->GetY()) + 
+                       abs(_terminal_z[i] - v->GetZ());
+            ret_ind = i;
+            return SUCCESS;
+        }
+    }
+
+    /* All terminals are in I. */
+    ret_dist = INT_MAX;
+    ret_ind = -1;
+    return SUCCESS;
+}
+
+uint64_t NearestTerminals::GetMemoryUsage() const {
+    return _lists.capacity() + _offsets.capacity() * sizeof(uint32_t);
+}
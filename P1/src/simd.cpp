@@ -0,0 +1,312 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * simd.cpp
+ *
+ *
+ * Implementation of functionality described in simd.hpp. The AVX2 and
+ * AVX-512 kernels are compiled for their instruction set using function
+ * attributes, so the rest of the program does not depend on it.
+ */
+
+#include "simd.hpp"
+
+#include <immintrin.h>
+
+using namespace std;
+
+/* Scalar kernels. */
+
+static int FindDisjointMasksScalar(const uint64_t *masks, int n, uint64_t I,
+                                   int *ret_indices) {
+    int n_found = 0;
+    for (int i = 0; i < n; i++) {
+        /* Write unconditionally and only advance on a hit, which avoids
+         * a hard-to-predict branch. */
+        ret_indices[n_found] = i;
+        n_found += ((masks[i] & I) == 0);
+    }
+    return n_found;
+}
+
+static void RectDistancesScalar(const int32_t *xs, const int32_t *ys, 
+                                const int32_t *zs, int n, 
+                                int32_t x, int32_t y, int32_t z, 
+                                int32_t *ret_dists) {
+    for (int i = 0; i < n; i++)
+        ret_dists[i] = abs(xs[i] - x) + abs(ys[i] - y) + abs(zs[i] - z);
+}
+
+static int32_t MaskedMinScalar(const int32_t *values, uint64_t mask, 
+                               int &ret_index) {
+    int32_t min = INT_MAX;
+    ret_index = -1;
+    for (; mask != 0; mask &= mask - 1) {
+        int i = __builtin_ctzll(mask);
+        if (values[i] < min) {
+            min = values[i];
+            ret_index = i;
+        }
+    }
+    return min;
+}
+
+/* AVX2 kernels. */
+
+__attribute__((target("avx2")))
+static int FindDisjointMasksAVX2(const uint64_t *masks, int n, uint64_t I,
+                                 int *ret_indices) {
+    int n_found = 0;
+    int i = 0;
+    const __m256i I_vec = _mm256_set1_epi64x((long long) I);
+    const __m256i zero = _mm256_setzero_si256();
+
+    /* Test four masks at a time. */
+    for (; i + 4 <= n; i += 4) {
+        __m256i m = _mm256_loadu_si256((const __m256i*) (masks + i));
+        __m256i is_zero = _mm256_cmpeq_epi64(_mm256_and_si256(m, I_vec),
+                                             zero);
+        int hits = _mm256_movemask_pd(_mm256_castsi256_pd(is_zero));
+        while (hits) {
+            ret_indices[n_found++] = i + __builtin_ctz(hits);
+            hits &= hits - 1;
+        }
+    }
+
+    /* Remaining masks. */
+    for (; i < n; i++) {
+        if ((masks[i] & I) == 0)
+            ret_indices[n_found++] = i;
+    }
+    return n_found;
+}
+
+__attribute__((target("avx2")))
+static void RectDistancesAVX2(const int32_t *xs, const int32_t *ys, 
+                              const int32_t *zs, int n, 
+                              int32_t x, int32_t y, int32_t z, 
+                              int32_t *ret_dists) {
+    const __m256i x_vec = _mm256_set1_epi32(x);
+    const __m256i y_vec = _mm256_set1_epi32(y);
+    const __m256i z_vec = _mm256_set1_epi32(z);
+
+    /* The arrays are padded, so we may run past n. */
+    for (int i = 0; i < n; i += 8) {
+        __m256i dx = _mm256_sub_epi32(
+            _mm256_loadu_si256((const __m256i*) (xs + i)), x_vec);
+        __m256i dy = _mm256_sub_epi32(
+            _mm256_loadu_si256((const __m256i*) (ys + i)), y_vec);
+        __m256i dz = _mm256_sub_epi32(
+            _mm256_loadu_si256((const __m256i*) (zs + i)), z_vec);
+        __m256i dist = _mm256_add_epi32(
+            _mm256_add_epi32(_mm256_abs_epi32(dx), _mm256_abs_epi32(dy)),
+            _mm256_abs_epi32(dz));
+        _mm256_storeu_si256((__m256i*) (ret_dists + i), dist);
+    }
+}
+
+/* Return a vector whose j-th entry is all ones if bit j of bits is set,
+ * and zero otherwise, for j = 0, ..., 7. */
+__attribute__((target("avx2")))
+static inline __m256i ExpandMaskAVX2(unsigned int bits) {
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(
+        _mm256_and_si256(_mm256_set1_epi32(bits), lane_bits), lane_bits);
+}
+
+/* Return the minimum of the entries of a vector. */
+__attribute__((target("avx2")))
+static inline int32_t HorizontalMinAVX2(__m256i v) {
+    __m128i m = _mm_min_epi32(_mm256_castsi256_si128(v), 
+                              _mm256_extracti128_si256(v, 1));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(1, 0, 3, 2)));
+    m = _mm_min_epi32(m, _mm_shuffle_epi32(m, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(m);
+}
+
+__attribute__((target("avx2")))
+static int32_t MaskedMinAVX2(const int32_t *values, uint64_t mask, 
+                             int &ret_index) {
+    ret_index = -1;
+    if (mask == 0)
+        return INT_MAX;
+
+    const __m256i inf = _mm256_set1_epi32(INT_MAX);
+    __m256i best = inf;
+    int n = 64 - __builtin_clzll(mask);
+    for (int i = 0; i < n; i += 8) {
+        __m256i in_mask = ExpandMaskAVX2((mask >> i) & 0xFF);
+        __m256i v = _mm256_loadu_si256((const __m256i*) (values + i));
+        best = _mm256_min_epi32(best, _mm256_blendv_epi8(inf, v, in_mask));
+    }
+    int32_t min = HorizontalMinAVX2(best);
+
+    /* Find the first position attaining the minimum. */
+    const __m256i min_vec = _mm256_set1_epi32(min);
+    for (int i = 0; i < n; i += 8) {
+        __m256i in_mask = ExpandMaskAVX2((mask >> i) & 0xFF);
+        __m256i v = _mm256_loadu_si256((const __m256i*) (values + i));
+        __m256i is_min = _mm256_and_si256(_mm256_cmpeq_epi32(v, min_vec), 
+                                          in_mask);
+        int hits = _mm256_movemask_ps(_mm256_castsi256_ps(is_min));
+        if (hits) {
+            ret_index = i + __builtin_ctz(hits);
+            break;
+        }
+    }
+    return min;
+}
+
+/* AVX-512 kernels. GCC wrongly warns about uninitialized values inside 
+ * several AVX-512 intrinsics, so we disable these warnings here. */
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+
+__attribute__((target("avx512f")))
+static int FindDisjointMasksAVX512(const uint64_t *masks, int n, uint64_t I,
+                                   int *ret_indices) {
+    int n_found = 0;
+    int i = 0;
+    const __m512i I_vec = _mm512_set1_epi64((long long) I);
+
+    /* Test eight masks at a time. */
+    for (; i + 8 <= n; i += 8) {
+        __m512i m = _mm512_loadu_si512((const void*) (masks + i));
+        unsigned int hits = _mm512_testn_epi64_mask(m, I_vec);
+        while (hits) {
+            ret_indices[n_found++] = i + __builtin_ctz(hits);
+            hits &= hits - 1;
+        }
+    }
+
+    /* Remaining masks. */
+    for (; i < n; i++) {
+        if ((masks[i] & I) == 0)
+            ret_indices[n_found++] = i;
+    }
+    return n_found;
+}
+
+__attribute__((target("avx512f")))
+static void RectDistancesAVX512(const int32_t *xs, const int32_t *ys, 
+                                const int32_t *zs, int n, 
+                                int32_t x, int32_t y, int32_t z, 
+                                int32_t *ret_dists) {
+    const __m512i x_vec = _mm512_set1_epi32(x);
+    const __m512i y_vec = _mm512_set1_epi32(y);
+    const __m512i z_vec = _mm512_set1_epi32(z);
+
+    /* The arrays are padded, so we may run past n. */
+    for (int i = 0; i < n; i += 16) {
+        __m512i dx = _mm512_sub_epi32(_mm512_loadu_si512(xs + i), x_vec);
+        __m512i dy = _mm512_sub_epi32(_mm512_loadu_si512(ys + i), y_vec);
+        __m512i dz = _mm512_sub_epi32(_mm512_loadu_si512(zs + i), z_vec);
+        __m512i dist = _mm512_add_epi32(
+            _mm512_add_epi32(_mm512_abs_epi32(dx), _mm512_abs_epi32(dy)),
+            _mm512_abs_epi32(dz));
+        _mm512_storeu_si512(ret_dists + i, dist);
+    }
+}
+
+__attribute__((target("avx512f")))
+static int32_t MaskedMinAVX512(const int32_t *values, uint64_t mask, 
+                               int &ret_index) {
+    ret_index = -1;
+    if (mask == 0)
+        return INT_MAX;
+
+    __m512i best = _mm512_set1_epi32(INT_MAX);
+    int n = 64 - __builtin_clzll(mask);
+    for (int i = 0; i < n; i += 16) {
+        __m512i v = _mm512_loadu_si512(values + i);
+        best = _mm512_mask_min_epi32(best, (__mmask16) (mask >> i), best, v);
+    }
+    int32_t min = _mm512_reduce_min_epi32(best);
+
+    /* Find the first position attaining the minimum. */
+    const __m512i min_vec = _mm512_set1_epi32(min);
+    for (int i = 0; i < n; i += 16) {
+        __m512i v = _mm512_loadu_si512(values + i);
+        unsigned int hits = _mm512_mask_cmpeq_epi32_mask(
+            (__mmask16) (mask >> i), v, min_vec);
+        if (hits) {
+            ret_index = i + __builtin_ctz(hits);
+            break;
+        }
+    }
+    return min;
+}
+
+#pragma GCC diagnostic pop
+
+/* Runtime dispatch. */
+
+static SimdLevel DetectSimdLevel() {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+        return SIMD_AVX512;
+    if (__builtin_cpu_supports("avx2"))
+        return SIMD_AVX2;
+    return SIMD_SCALAR;
+}
+
+/* The instruction set used by all kernels. */
+static SimdLevel simd_level = DetectSimdLevel();
+
+SimdLevel GetSimdLevel() { return simd_level; }
+
+Result SetSimdLevel(SimdLevel level) {
+    if (level > DetectSimdLevel())
+        return FAIL;
+    simd_level = level;
+    return SUCCESS;
+}
+
+const char *GetSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SIMD_AVX512: return "AVX-512";
+        case SIMD_AVX2: return "AVX2";
+        default: return "scalar";
+    }
+}
+
+int FindDisjointMasks(const uint64_t *masks, int n, uint64_t I,
+                      int *ret_indices) {
+    switch (simd_level) {
+        case SIMD_AVX512: 
+            return FindDisjointMasksAVX512(masks, n, I, ret_indices);
+        case SIMD_AVX2: 
+            return FindDisjointMasksAVX2(masks, n, I, ret_indices);
+        default: 
+            return FindDisjointMasksScalar(masks, n, I, ret_indices);
+    }
+}
+
+void RectDistances(const int32_t *xs, const int32_t *ys, const int32_t *zs,
+                   int n, int32_t x, int32_t y, int32_t z, 
+                   int32_t *ret_dists) {
+    switch (simd_level) {
+        case SIMD_AVX512: 
+            return RectDistancesAVX512(xs, ys, zs, n, x, y, z, ret_dists);
+        case SIMD_AVX2: 
+            return RectDistancesAVX2(xs, ys, zs, n, x, y, z, ret_dists);
+        default: 
+            return RectDistancesScalar(xs, ys, zs, n, x, y, z, ret_dists);
+    }
+}
+
+int32_t MaskedMin(const int32_t *values, uint64_t mask, int &ret_index) {
+    switch (simd_level) {
+        case SIMD_AVX512: 
+            return MaskedMinAVX512(values, mask, ret_index);
+        case SIMD_AVX2: 
+            return MaskedMinAVX2(values, mask, ret_index);
+        default: 
+            return MaskedMinScalar(values, mask, ret_index);
+    }
+}
@@ -18,40 +18,98 @@ Result Solver::SetGlobalUpperBound() {
         all_terminals.set(i);
     }
     _global_upper_bound = _bound_comp->MST(all_terminals);
+    _MST_upper_bound = _global_upper_bound;
+    if (!_heuristic)
+        return SUCCESS;
+
+    /* Fewer vertices make the heuristic faster. */
+    EliminateVertices();
+    SteinerHeuristic heuristic(_problem_instance);
+    heuristic.Run();
+    if (heuristic.GetLength() < _global_upper_bound)
+        _global_upper_bound = heuristic.GetLength();
+
+    /* The subtree of a point v of the heuristic tree connects v with 
+     * the terminals I in it, as does the subtree together with the edge
+     * to the parent p of v for p. */
+    for (int i = 1; i < heuristic.GetNPoints(); i++) {
+        bitset<BITSET_SIZE> I(heuristic.GetSubtreeMask(i));
+        if (I.none())
+            continue;
+        Vertex *v = heuristic.GetPoint(i);
+        Vertex *p = heuristic.GetPoint(heuristic.GetParent(i));
+        int length = heuristic.GetSubtreeLength(i);
+        _bound_comp->UpdateUpperBound(I, v, length);
+        _bound_comp->UpdateUpperBound(I, p, length + RectDistance(v, p));
+    }
     return SUCCESS;
 }
 
-Result Solver::AddLabelToN(Label* l) {
-    if (!l->IsLowerBoundSet())
-        l->SetLowerBound(_bound_comp->GetLowerBound(l)); 
-
-    /* Don't add labels that certainly won't contribute to a solution:
-     * see Lemma 14 and 15 in Hougardy et al. */
-    if (l->GetL() > _global_upper_bound) {
+Result Solver::EliminateVertices() {
+    if (!_eliminate)
         return FAIL;
+    int n_removed, n_removed_edges;
+    _problem_instance->EliminateVertices(_global_upper_bound, n_removed);
+    _n_eliminated += n_removed;
+
+    DualAscent *dual_ascent = _bound_comp->GetDualAscent();
+    if (dual_ascent != NULL) {
+        dual_ascent->EliminateVertices(_global_upper_bound, n_removed, 
+                                       n_removed_edges);
+        _n_eliminated += n_removed;
     }
-    if (_bound_comp->CompareToUpperBound(l)) {
+    return SUCCESS;
+}
+
+bool Solver::IsPrunable(const bitset<BITSET_SIZE> &I, int l) {
+    /* See Lemma 14 and 15 in Hougardy et al. */
+    if (l > _global_upper_bound)
+        return true;
+    return _bound_comp->CompareToUpperBound(I, l);
+}
+
+Label *Solver::NewLabel(Vertex *v, const bitset<BITSET_SIZE> &I, int l) {
+    Label *label = _label_store->NewLabel(v, I);
+    label->SetL(l);
+    v->AddLabel(label);
+    _label_table->AddLabel(label);
+    return label;
+}
+
+template <class LowerBound>
+Result Solver::AddLabelToN(Label* l) {
+    /* Don't add labels that certainly won't contribute to a solution. 
+     * Labels are checked before they are created, so this can only 
+     * fail for labels whose value was just updated. */
+    if (IsPrunable(l->GetBitset(), l->GetL()))
         return FAIL;
-    }
 
-    _N.push(make_pair(l->GetL() + l->GetLowerBound(), l));
-    return SUCCESS;
+    if (!l->IsLowerBoundSet())
+        l->SetLowerBound(LowerBound::Compute(_bound_comp, l));
+
+    /* With a consistent lower bound, labels found while expanding a 
+     * label with key k have a key of at least k. With a lazy bound only
+     * the refined key is known to be, so a label whose key is not larger
+     * than k would be popped and refined right away. We refine it now 
+     * instead, and raise its key to k, which keeps the keys in N 
+     * monotone. */
+    if (l->GetL() + l->GetLowerBound() <= _current_key)
+        BoundRefinement<LowerBound>::Refine(_bound_comp, l);
+    return _N->Push(l, max(l->GetL() + l->GetLowerBound(), _current_key));
 }
 
+template <class LowerBound>
 Result Solver::SetInitialN() {
     int n = _problem_instance->GetNTerminals();
     for (int i = 1; i < n; i++) {
         bitset<BITSET_SIZE> b;
         b.set(i);
         
+        if (IsPrunable(b, 0))
+            continue;
+
         Vertex *s = _problem_instance->GetTerminals()[i];
-        Label *l = new Label(s, b);
-        
-        l->SetL(0);
-        if (AddLabelToN(l) == SUCCESS)
-            s->AddLabel(l);
-        else
-            delete l;
+        AddLabelToN<LowerBound>(NewLabel(s, b, 0));
     }
     return SUCCESS;
 }
@@ -60,127 +118,549 @@ Result Solver::SetInitialLabels() {
     int n = _problem_instance->GetNVertices();
     bitset<BITSET_SIZE> b;
     
+    /* The labels (v, emptyset) are never looked up by their bitset,
+     * so we do not add them to the label table, except for the root if
+     * R = {root}, since (root, emptyset) then is the solution. */
     for (int i = 0; i < n; i++) {
         Vertex *v = _problem_instance->GetVertices()[i];
-        Label *l = new Label(v, b);
+        Label *l = _label_store->NewLabel(v, b);
         l->SetL(0);
         l->SetInP();
         v->AddLabel(l);
+        if (v->IsRoot() && _problem_instance->GetNTerminals() == 1)
+            _label_table->AddLabel(l);
     }
     return SUCCESS;
 }
 
-Result Solver::ConsiderNeighbours(Label *v_label) {
+Result Solver::ConsiderNeighbours(Label *v_label, ExpansionBuffer &buf) {
     Vertex *v = v_label->GetVertex();
-    bitset<BITSET_SIZE> I = v_label->GetBitset();
+    const bitset<BITSET_SIZE> &I = v_label->GetBitset();
 
     /* Loop over neighbours of v. */
     for (int i = 0; i < v->GetNNeighbours(); i++) {
         Vertex *w = v->GetNeighbours()[i];
+        int new_l = v_label->GetL() + RectDistance(v, w);
         
-        /* (w, I) not yet set so set it and add it to N 
-         * and the labels of w. */
-        Label *w_label;
-        if ((w_label = w->GetLabelByBitset(I)) == NULL) {
-            w_label = new Label(w, I);
-            w_label->SetL(v_label->GetL() + RectDistance(v, w));
-            /* Try to add label to N. If this succeeds add it to v.
-             * If not, delete label. */
-            if (AddLabelToN(w_label) == SUCCESS)
-                w->AddLabel(w_label);
-            else
-                delete w_label;
-        }
-        /* (w, I) already set, check if l(v, I) + d(v, w) < l(w, I) and 
-         * if so replace l(w, I) by this value and add (w, I) to N. */
-        else {
-            if (!w_label->IsInP() && 
-                v_label->GetL() + RectDistance(v,w) < w_label->GetL()) {
-                w_label->SetL(v_label->GetL() + RectDistance(v,w));
-                AddLabelToN(w_label);
-            }
+        /* If (w, I) is not yet set, we do not create it if it would be
+         * pruned anyways. If it is set, l(v, I) + d(v, w) should be
+         * smaller than l(w, I), and (w, I) should not be in P. */
+        Label *w_label = _label_table->GetLabel(w->GetId(), I);
+        if (w_label == NULL) {
+            if (IsPrunable(I, new_l))
+                continue;
         }
+        else if (w_label->IsInP() || new_l >= w_label->GetL())
+            continue;
+
+        LabelCandidate c;
+        c._v = w;
+        c._I = I;
+        c._l = new_l;
+        c._label = w_label;
+        c._source = v_label;
+        buf._candidates.push_back(c);
     }
     return SUCCESS;
 }
 
-Result Solver::Merge(Label *I_label) {
+Result Solver::Merge(Label *I_label, ExpansionBuffer &buf) {
     Vertex* v = I_label->GetVertex();
-    bitset<BITSET_SIZE> I = I_label->GetBitset();
-    vector<Label*> labels = v->GetLabels();
-
-    /* Loop over all labels associated with v. In the
-     * implementation by Hougardy et al. the loop runs
-     * over all valid (v, J) instead (regardless of whether 
-     * they are associated with v yet) if this allows us to 
-     * consider fewer options. We choose not to implement
-     * this as it is very rare. Furthermore, we know that the 
-     * label (v, emptyset) is always at index 0 in the vector, 
-     * so instead of explicetely testing if J is empty, we simply
-     * start at index 1. */
-    unsigned int labels_size = labels.size();
-    for (unsigned int i = 1; i < labels_size; i++) {
-        Label *J_label = labels[i];
-        bitset<BITSET_SIZE> J = J_label->GetBitset();
-        
-        /* (v,J) should be in P, J should be non-empty, not 
-         * contain root and have no terminals in common with I.
-         * Since J should not contain root anyways, we do not check this. */
-        if (J_label->IsInP() && (I & J).none()) {
-            bitset<BITSET_SIZE> IJ = I | J;
-
-            /* If (v, I u J) not yet set, set it and add it to N and 
-             * the label array of v. In this case (v, I u J) is not in P */
-            Label *IJ_label;
-            if ((IJ_label = v->GetLabelByBitset(IJ)) == NULL) {    
-                IJ_label = new Label(v, IJ);
-                IJ_label->SetL(I_label->GetL() + J_label->GetL());
-    
-                /* Attempt to improve the local upper bound for I u J. */
-                _bound_comp->MergeUpperBound(I, J);
-                
-                /* Try to add label to N. If this succeeds add it to v. 
-                 * If not, delete label. */
-                if (AddLabelToN(IJ_label) == SUCCESS)
-                    v->AddLabel(IJ_label);
-                else
-                    delete IJ_label;
-            }
-            /* If (v, IuJ) already set, check if l(v, I) + l(v, J) < l(v, IuJ)
-             * and l(v, IuJ) is not in P. If so replace l(v, IuJ) by this 
-             * value and add (v, IuJ) to N */
-            else {
-                if (!IJ_label->IsInP() &&
-                    I_label->GetL() + J_label->GetL() < IJ_label->GetL()) {
-     
-                    /* Attempt to improve the local upper bound for I u J. */
-                    _bound_comp->MergeUpperBound(I, J);
-     
-                    IJ_label->SetL(I_label->GetL() + J_label->GetL());
-                    AddLabelToN(IJ_label);
-                }
+    const bitset<BITSET_SIZE> &I = I_label->GetBitset();
+    const vector<uint64_t> &P_masks = v->GetPermanentMasks();
+    const vector<int> &P_values = v->GetPermanentValues();
+
+    LabelCandidate c;
+    c._v = v;
+    c._I = I;
+    c._source = I_label;
+
+    /* Candidates J are the non-empty subsets of R - I - {root} for
+     * which (v, J) is in P. As in the implementation by Hougardy et al., 
+     * we either loop over all labels (v, J) in P, or over all these 
+     * subsets J (looking up (v, J) for each of them), whichever is 
+     * cheaper. */
+    uint64_t complement = (_final_terminal_set & ~I).to_ullong();
+    int n_complement = __builtin_popcountll(complement);
+    unsigned int n_permanent = P_masks.size();
+
+    if (n_complement < 32 && 
+        ((uint64_t) 1 << n_complement) * MERGE_LOOKUP_COST < n_permanent) {
+        /* Loop over all non-empty subsets J of the complement. */
+        for (uint64_t J = complement; J != 0; J = (J - 1) & complement) {
+            Label *J_label = 
+                _label_table->GetLabel(v->GetId(), bitset<BITSET_SIZE>(J));
+            if (J_label != NULL && J_label->IsInP()) {
+                c._J = J_label->GetBitset();
+                c._l = I_label->GetL() + J_label->GetL();
+                c._label = _label_table->GetLabel(v->GetId(), I | c._J);
+
+                /* (v, I u J) should not be in P, and should improve. */
+                if (c._label != NULL && 
+                    (c._label->IsInP() || c._l >= c._label->GetL()))
+                    continue;
+                buf._candidates.push_back(c);
             }
         }
+        return SUCCESS;
+    }
+
+    /* Find all J in P which have no terminals in common with I. Since 
+     * J should not contain root anyways, we do not check this. */
+    if (buf._merge_hits.size() < n_permanent)
+        buf._merge_hits.resize(2 * n_permanent);
+    int n_hits = FindDisjointMasks(P_masks.data(), n_permanent, 
+                                   I.to_ullong(), buf._merge_hits.data());
+    
+    for (int i = 0; i < n_hits; i++) {
+        int j = buf._merge_hits[i];
+        c._J = bitset<BITSET_SIZE>(P_masks[j]);
+        c._l = I_label->GetL() + P_values[j];
+        c._label = _label_table->GetLabel(v->GetId(), I | c._J);
+
+        /* (v, I u J) should not be in P, and should improve. */
+        if (c._label != NULL && 
+            (c._label->IsInP() || c._l >= c._label->GetL()))
+            continue;
+        buf._candidates.push_back(c);
     }
     return SUCCESS;
 }
 
-Solver::Solver(Instance *problem_instance, BoundComputator *bound_comp) {
+template <class LowerBound>
+Result Solver::ApplyCandidate(const LabelCandidate &c, 
+                              vector<Label*> *new_labels) {
+    bitset<BITSET_SIZE> IJ = c._I | c._J;
+    bool is_merge = c._J.any();
+
+    /* (v, I u J) may have been created by an earlier candidate. */
+    Label *label = c._label;
+    if (label == NULL)
+        label = _label_table->GetLabel(c._v->GetId(), IJ);
+
+    /* If (v, I u J) is not yet set, set it and add it to N, unless
+     * it would be pruned anyways, in which case we do not create it 
+     * at all. */
+    if (label == NULL) {
+        /* Attempt to improve the local upper bound for I u J. */
+        if (is_merge)
+            _bound_comp->MergeUpperBound(c._I, c._J);
+
+        if (IsPrunable(IJ, c._l))
+            return FAIL;
+
+        /* d(I u J, R - I - J) is only needed once the label is popped,
+         * so it can be computed on the side meanwhile. */
+        if (is_merge)
+            _bound_comp->PrefetchSubset(IJ);
+
+        label = NewLabel(c._v, IJ, c._l);
+        label->SetPredecessor(c._source->GetIndex());
+        if (new_labels != NULL) {
+            new_labels->push_back(label);
+            return SUCCESS;
+        }
+        return AddLabelToN<LowerBound>(label);
+    }
+
+    /* If (v, I u J) is already set, an earlier candidate may have 
+     * improved it further or moved it to P. */
+    if (label->IsInP() || c._l >= label->GetL())
+        return FAIL;
+
+    /* Attempt to improve the local upper bound for I u J. */
+    if (is_merge)
+        _bound_comp->MergeUpperBound(c._I, c._J);
+
+    label->SetL(c._l);
+    label->SetPredecessor(c._source->GetIndex());
+    if (new_labels != NULL) {
+        _updated_labels.push_back(label);
+        return SUCCESS;
+    }
+    return AddLabelToN<LowerBound>(label);
+}
+
+Result Solver::RunInParallel(int n, 
+                             const function<void(int, int, int)> &task) {
+    if (_thread_pool == NULL || n < PARALLEL_MIN_BATCH) {
+        task(0, 0, n);
+        return SUCCESS;
+    }
+
+    int n_parts = _n_threads;
+    return _thread_pool->Run([&](int t) {
+        task(t, (int64_t) n * t / n_parts, (int64_t) n * (t + 1) / n_parts);
+    });
+}
+
+Solver::Solver(Instance *problem_instance, BoundComputator *bound_comp,
+               SolverOptions *opts) {
     _problem_instance = problem_instance;
     _bound_comp = bound_comp;
 
+    /* Extract solver options. */
+    if (opts != NULL) {
+        _queue_type = opts->_queue_type;
+        _n_threads = opts->_n_threads;
+        _eliminate = opts->_eliminate;
+        _heuristic = opts->_heuristic;
+        _sweep = opts->_sweep;
+        free(opts);
+    }
+    else {
+        _queue_type = BUCKET_QUEUE;
+        _n_threads = 1;
+        _eliminate = _bound_comp->GetUseDualAscentLowerBound();
+        _heuristic = true;
+        _sweep = false;
+    }
+    if (_n_threads < 1)
+        _n_threads = 1;
+    _thread_pool = (_n_threads > 1) ? new ThreadPool(_n_threads) : NULL;
+    _buffers.resize(_n_threads);
+    _bound_comp->PrecomputeSubsetTable(_thread_pool);
+
+    _n_eliminated = 0;
     SetGlobalUpperBound();
+    EliminateVertices();
+    if (_bound_comp->ComputeDualAscent() == SUCCESS)
+        EliminateVertices();
+
+    _label_store = new LabelStore();
+    _n_retired = 0;
+    _current_key = 0;
+
+    /* We expect a number of labels in the order of the number of
+     * vertices times the number of terminals. */
+    _label_table = new LabelTable(_label_store, 
+                    (uint64_t) problem_instance->GetNVertices() *
+                    problem_instance->GetNTerminals());
+
+    /* The final terminal set contains all terminals but the root,
+     * which is always just the first one given. */
+    for (int i = 1; i < _problem_instance->GetNTerminals(); i++)
+        _final_terminal_set.set(i);
+
+    /* Labels with a key larger than the global upper bound are never
+     * popped before the solution is found, so a bucket queue only 
+     * needs keys up to this bound. */
+    if (_queue_type == BUCKET_QUEUE)
+        _N = new BucketLabelQueue(_global_upper_bound);
+    else
+        _N = new HeapLabelQueue();
+}
+
+Solver::~Solver() {
+    /* Frees all labels at once. */
+    delete _thread_pool;
+    delete _N;
+    delete _label_table;
+    delete _label_store;
+}
+
+Result Solver::RetireLabel(Label *l) {
+    if (_queue_type != BUCKET_QUEUE || l->Retire() == FAIL)
+        return FAIL;
+    _label_table->RemoveLabel(l);
+    _n_retired ++;
+
+    _removed_labels.clear();
+    l->GetVertex()->RetireLabel(_removed_labels);
+    for (unsigned int i = 0; i < _removed_labels.size(); i++)
+        _label_store->ReleaseLabel(_removed_labels[i]);
+    return SUCCESS;
+}
+
+template <class LowerBound>
+Label *Solver::PopPermanentLabel(bool &done) {
+    int key = _N->GetMinKey();
+    Label *current_label = _N->Pop();
+    if (current_label == NULL)
+        return NULL;
+    _bound_comp->StorePrefetchedSubsets();
+
+    /* A copy with a key below l(v, I) + LB is a stale copy left over
+     * from before the lower bound of the label was refined. The copy
+     * with the refined key is still in N, so ignore this one. */
+    if (!current_label->IsInP() &&
+        key < current_label->GetL() + current_label->GetLowerBound())
+        return NULL;
+
+    /* Compute the stronger bound of a lazy policy only now. */
+    if (!current_label->IsInP() && 
+        BoundRefinement<LowerBound>::Refine(_bound_comp, current_label)) {
+        AddLabelToN<LowerBound>(current_label);
+        return NULL;
+    }
+
+    if (!current_label->IsInP())
+        _current_key = current_label->GetL() + 
+                       current_label->GetLowerBound();
+
+    /* Update the local upper bound for I. */
+    _bound_comp->UpdateUpperBound(current_label);
+
+    /* Attempt to prune according to Lemma 15. */
+    if (_bound_comp->CompareToUpperBound(current_label)) {
+        RetireLabel(current_label);
+        return NULL;
+    }
+
+    /* Add label to P. If it already was in P, then this is 
+     * a token label (i.e. it is copy left over from when
+     * the priority value of the label was changed),
+     * and we should ignore it. This only happens if _N 
+     * does not support decrease-key. */
+    if (current_label->SetInP() == FAIL)
+        return NULL;
+    current_label->GetVertex()->AddPermanentLabel(current_label);
+
+    /* Check if current label = (root, terminals - {root})
+     * in which case we are done */
+    if (current_label->GetVertex()->IsRoot() && 
+        current_label->GetBitset() == _final_terminal_set)
+        done = true;
+    return current_label;
+}
+
+template <class LowerBound>
+Result Solver::SolveSequential() {
+    ExpansionBuffer &buf = _buffers[0];
+    bool done = false;
+
+    /* Keep fetching the highest priority label from N. */
+    while (!done && _N->GetMinKey() >= 0) {
+        Label *current_label = PopPermanentLabel<LowerBound>(done);
+        if (current_label == NULL || done)
+            continue;
+
+        /* Perform the Dijkstra-step for each neighbour and the 
+         * merge-step, and apply the results right away. */
+        ConsiderNeighbours(current_label, buf);
+        Merge(current_label, buf);
+        for (unsigned int i = 0; i < buf._candidates.size(); i++)
+            ApplyCandidate<LowerBound>(buf._candidates[i], NULL);
+        buf._candidates.clear();
+    }
+    return SUCCESS;
+}
+
+template <class LowerBound>
+Result Solver::SolveParallel() {
+    bool done = false;
+
+    while (!done) {
+        /* Move all labels with the minimum key to P. */
+        int key = _N->GetMinKey();
+        if (key < 0)
+            break;
+        _batch.clear();
+        while (!done && _N->GetMinKey() == key) {
+            Label *current_label = PopPermanentLabel<LowerBound>(done);
+            if (current_label != NULL)
+                _batch.push_back(current_label);
+        }
+        if (done)
+            break;
+
+        /* Perform the Dijkstra-step and the merge-step for all of them
+         * at the same time. This only reads labels and bounds. */
+        RunInParallel(_batch.size(), [&](int t, int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                ConsiderNeighbours(_batch[i], _buffers[t]);
+                Merge(_batch[i], _buffers[t]);
+            }
+        });
+
+        /* Apply the candidates in the order a single thread would 
+         * have found them. */
+        _new_labels.clear();
+        _updated_labels.clear();
+        for (int t = 0; t < _n_threads; t++) {
+            vector<LabelCandidate> &candidates = _buffers[t]._candidates;
+            for (unsigned int i = 0; i < candidates.size(); i++)
+                ApplyCandidate<LowerBound>(candidates[i], &_new_labels);
+            candidates.clear();
+        }
+
+        /* Compute the lower bounds of the new labels at the same time,
+         * after making sure this does not change the hash tables of 
+         * the bound computator. New labels with the same terminal set
+         * are mostly created one after another. */
+        for (unsigned int i = 0; i < _new_labels.size(); i++) {
+            if (i == 0 || _new_labels[i]->GetBitset() != 
+                          _new_labels[i - 1]->GetBitset())
+                _bound_comp->PrepareLowerBound(_new_labels[i]->GetBitset());
+        }
+        RunInParallel(_new_labels.size(), [&](int t, int begin, int end) {
+            for (int i = begin; i < end; i++) {
+                _new_labels[i]->SetLowerBound(
+                    LowerBound::Compute(_bound_comp, _new_labels[i]));
+            }
+        });
+
+        for (unsigned int i = 0; i < _new_labels.size(); i++)
+            AddLabelToN<LowerBound>(_new_labels[i]);
+        for (unsigned int i = 0; i < _updated_labels.size(); i++)
+            AddLabelToN<LowerBound>(_updated_labels[i]);
+    }
+    return SUCCESS;
+}
+
+template <class LowerBound>
+Result Solver::Solve() {
+    SetInitialN<LowerBound>();
+    if (_thread_pool != NULL)
+        return SolveParallel<LowerBound>();
+    return SolveSequential<LowerBound>();
+}
+
+Result Solver::SampleLowerBounds() {
+    int min_size = _bound_comp->GetOneTreeMinSize();
+    for (unsigned int i = 0; i < _new_labels.size(); i++) {
+        Label *l = _new_labels[i];
+        int size = l->GetBitset().count();
+        int BB = _bound_comp->BBLowerBound(l);
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        int onetree = _bound_comp->OneTreeLowerBound(l);
+        chrono::duration<double> time = chrono::steady_clock::now() - start;
+
+        /* The label is pruned by the 1-tree bound if its key would exceed
+         * the global upper bound only with this bound. */
+        BoundSample &sample = _bound_samples[size];
+        sample._n_labels ++;
+        sample._time += time.count();
+        if (l->GetL() + BB <= _global_upper_bound && 
+            l->GetL() + onetree > _global_upper_bound)
+            sample._n_pruned ++;
+
+        /* Same as AdaptiveBoundPolicy. */
+        l->SetLowerBound(size >= min_size ? max(BB, onetree) : BB);
+    }
+    return SUCCESS;
+}
+
+Result Solver::SelectLowerBound(long n_expanded, double seconds) {
+    int n = _problem_instance->GetNTerminals();
+    int old_min_size = _bound_comp->GetOneTreeMinSize();
+    double expand_time = seconds / n_expanded;
+
+    /* Using the 1-tree bound for the sets of size k saves expanding the 
+     * labels it prunes, and costs computing it. Sum the gain over the 
+     * sizes from large to small and take the size where it is largest, 
+     * where n means the bounding box bound only. */
+    int min_size = n;
+    double gain = 0, best_gain = 0;
+    long n_sampled = 0, n_pruned = 0;
+    for (int k = n - 1; k >= 1; k--) {
+        const BoundSample &sample = _bound_samples[k];
+        gain += sample._n_pruned * expand_time - sample._time;
+        if (gain > best_gain) {
+            best_gain = gain;
+            min_size = k;
+        }
+        n_sampled += sample._n_labels;
+        n_pruned += sample._n_pruned;
+    }
+
+    cerr << "Adaptive bound: " << n_expanded << " labels expanded (" <<
+            expand_time * 1e6 << " us each), 1-tree bound prunes " << 
+            n_pruned << " of " << n_sampled << " sampled labels, ";
+    if (min_size == n)
+        cerr << "using the bounding box bound only\n";
+    else
+        cerr << "using the 1-tree bound for |I| >= " << min_size << "\n";
+    if (min_size == old_min_size)
+        return SUCCESS;
+    _bound_comp->SetOneTreeMinSize(min_size);
+
+    /* Only the labels with sizes between the old and new choice get a 
+     * different bound. Labels that are not in N keep their bound until
+     * they are added again. */
+    int low = min(old_min_size, min_size);
+    int high = max(old_min_size, min_size);
+    const vector<Vertex*> &vertices = _problem_instance->GetVertices();
+    for (unsigned int i = 0; i < vertices.size(); i++) {
+        const vector<Label*> &labels = vertices[i]->GetLabels();
+        for (unsigned int j = 0; j < labels.size(); j++) {
+            Label *l = labels[j];
+            if (l->IsInP() || l->GetQueueKey() < 0)
+                continue;
+            int size = l->GetBitset().count();
+            if (size < low || size >= high)
+                continue;
+            l->SetLowerBound(AdaptiveBoundPolicy::Compute(_bound_comp, l));
+            _N->Push(l, l->GetL() + l->GetLowerBound());
+        }
+    }
+    return SUCCESS;
+}
+
+Result Solver::SolveAdaptive() {
+    typedef AdaptiveBoundPolicy LowerBound;
+    ExpansionBuffer &buf = _buffers[0];
+    int n = _problem_instance->GetNTerminals();
+    bool done = false;
+
+    /* Start with the bounding box bound only. */
+    _bound_comp->SetOneTreeMinSize(n);
+    _bound_samples.assign(n, BoundSample());
+    SetInitialN<LowerBound>();
+
+    long n_expanded = 0;
+    long next_decision = ADAPTIVE_FIRST_DECISION;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while (!done && _N->GetMinKey() >= 0) {
+        Label *current_label = PopPermanentLabel<LowerBound>(done);
+        if (current_label == NULL || done)
+            continue;
+
+        ConsiderNeighbours(current_label, buf);
+        Merge(current_label, buf);
+
+        /* Labels found by a sampled label are added to N after both 
+         * bounds have been computed for the new ones. */
+        bool sample = (n_expanded % ADAPTIVE_SAMPLE_RATE == 0);
+        _new_labels.clear();
+        _updated_labels.clear();
+        for (unsigned int i = 0; i < buf._candidates.size(); i++)
+            ApplyCandidate<LowerBound>(buf._candidates[i], 
+                                       sample ? &_new_labels : NULL);
+        buf._candidates.clear();
+        if (sample) {
+            SampleLowerBounds();
+            for (unsigned int i = 0; i < _new_labels.size(); i++)
+                AddLabelToN<LowerBound>(_new_labels[i]);
+            for (unsigned int i = 0; i < _updated_labels.size(); i++)
+                AddLabelToN<LowerBound>(_updated_labels[i]);
+        }
+
+        if (++n_expanded == next_decision) {
+            chrono::duration<double> seconds = 
+                chrono::steady_clock::now() - start;
+            SelectLowerBound(n_expanded, seconds.count());
+            next_decision *= 2;
+        }
+    }
+    return SUCCESS;
 }
 
 Result Solver::SolveCurrentInstance(int &ret) {
     /* Set the root terminal (which is always just the
-     * first one given) and the final terminal set 
-     * (i.e. the set containing all terminals but the root). */
+     * first one given). */
     Vertex *root = _problem_instance->GetTerminals()[0];
     _problem_instance->GetTerminals()[0]->SetRoot();
-    bitset<BITSET_SIZE> final_terminal_set;
-    for (int i = 1; i < _problem_instance->GetNTerminals(); i++)
-        final_terminal_set.set(i);
+
+    /* The engine only uses the terminals, so it does not matter that the
+     * grid may have been reduced already. */
+    if (_sweep && SweepEngine::MemoryUsage(_problem_instance) <= 
+                  SWEEP_DEFAULT_MAX_MEMORY) {
+        SweepEngine engine(_problem_instance);
+        engine.Run();
+        ret = engine.GetLength();
+        return SUCCESS;
+    }
 
     /* Add (s, {s}) to _N for each terminal s unequal to 
      * the root, and set (s, emptyset) for all vertices s. 
@@ -188,45 +668,41 @@ Result Solver::SolveCurrentInstance(int &ret) {
      * the label (v, emptyset) is always at index 0 in the 
      * vector containing the labels of v. */
     SetInitialLabels();
-    SetInitialN();
 
-    Label *current_label;
+    /* Pick the lower bound policy once, so that the main loop does not
+     * need to check which lower bound is used for every label. */
+    bool use_BB = _bound_comp->GetUseBBLowerBound();
+    bool use_onetree = _bound_comp->GetUseOneTreeLowerBound();
+    bool use_dual_ascent = _bound_comp->GetUseDualAscentLowerBound();
+    bool lazy = _bound_comp->GetLazyLowerBound();
 
-    while (_N.size() > 0) {
-        /* Fetch the highest piority label from N */
-        current_label = _N.top().second; 
-        _N.pop();
-
-        /* Update the local upper bound for I. */
-        _bound_comp->UpdateUpperBound(current_label);
-
-        /* Attempt to prune according to Lemma 15. */
-        if (_bound_comp->CompareToUpperBound(current_label))
-            continue;
-
-        /* Add label to P. If it already was in P, then this is 
-         * a token label (i.e. it is copy left over from when
-         * the priority value of the label was changed),
-         * and we should ignore it */
-        if (current_label->SetInP() == FAIL)
-            continue;
-
-        /* Check if current label = (root, terminals - {root})
-         * in which case we are done */
-        if (current_label->GetVertex()->IsRoot() && 
-            current_label->GetBitset() == final_terminal_set)
-            break;
-
-        /* Perform the Dijkstra-step for each neighbour */
-        ConsiderNeighbours(current_label);
-        
-        /* Perform the merge-step */
-        Merge(current_label);    
-    }
+    /* The adaptive bound changes the keys of labels in N, which needs
+     * decrease-key. */
+    bool adaptive = _bound_comp->GetAdaptiveLowerBound() && 
+                    _queue_type == BUCKET_QUEUE;
+    if (adaptive && use_BB && use_onetree)
+        SolveAdaptive();
+    else if (lazy && use_dual_ascent && use_BB)
+        Solve<LazyBoundPolicy<BBBoundPolicy, DualAscentBoundPolicy> >();
+    else if (lazy && use_BB && use_onetree)
+        Solve<LazyBoundPolicy<BBBoundPolicy, OneTreeBoundPolicy> >();
+    else if (use_dual_ascent && use_BB)
+        Solve<MaxBoundPolicy<BBBoundPolicy, DualAscentBoundPolicy> >();
+    else if (use_dual_ascent)
+        Solve<DualAscentBoundPolicy>();
+    else if (use_BB && use_onetree)
+        Solve<MaxBoundPolicy<BBBoundPolicy, OneTreeBoundPolicy> >();
+    else if (use_BB)
+        Solve<BBBoundPolicy>();
+    else if (use_onetree)
+        Solve<OneTreeBoundPolicy>();
+    else
+        Solve<NoBoundPolicy>();
 
     /* Try and find l(root, R - {root}) and return it if found. */
     Label *l;
-    if ((l = root->GetLabelByBitset(final_terminal_set)) != NULL) {
+    if ((l = _label_table->GetLabel(root->GetId(), _final_terminal_set)) 
+            != NULL) {
         ret = l->GetL();
         return SUCCESS;
     }
@@ -235,3 +711,79 @@ Result Solver::SolveCurrentInstance(int &ret) {
         return FAIL;
     }
 }
+
+/* Append the segments of the edge between a and b to ret_segments. */
+static void AppendSegments(Vertex *a, Vertex *b, 
+                           vector<TreeSegment> &ret_segments) {
+    int from[3] = { a->GetX(), a->GetY(), a->GetZ() };
+    const int to[3] = { b->GetX(), b->GetY(), b->GetZ() };
+    for (int axis = 0; axis < 3; axis++) {
+        if (from[axis] == to[axis])
+            continue;
+        TreeSegment segment;
+        segment._x1 = from[0];
+        segment._y1 = from[1];
+        segment._z1 = from[2];
+        from[axis] = to[axis];
+        segment._x2 = from[0];
+        segment._y2 = from[1];
+        segment._z2 = from[2];
+        ret_segments.push_back(segment);
+    }
+}
+
+Result Solver::GetSolutionTree(vector<TreeSegment> &ret_segments,
+                               vector<Vertex*> &ret_steiner_points) {
+    ret_segments.clear();
+    ret_steiner_points.clear();
+    Vertex *root = _problem_instance->GetTerminals()[0];
+    Label *l = _label_table->GetLabel(root->GetId(), _final_terminal_set);
+    if (l == NULL)
+        return FAIL;
+
+    /* Terminals are never Steiner points. */
+    vector<int> degrees(_problem_instance->GetIdBound(), 0);
+    for (int i = 0; i < _problem_instance->GetNTerminals(); i++)
+        degrees[_problem_instance->GetTerminals()[i]->GetId()] = INT_MIN;
+
+    /* The labels of the tree form a binary tree, in which the labels 
+     * (s, {s}) of the terminals have no predecessor. For a merge, the 
+     * other label (v, I - J) is found in the label table. */
+    vector<Label*> stack(1, l);
+    while (!stack.empty()) {
+        Label *label = stack.back();
+        stack.pop_back();
+        if (label->GetPredecessor() == LABEL_NO_PREDECESSOR)
+            continue;
+        Label *predecessor = _label_store->GetLabel(label->GetPredecessor());
+        stack.push_back(predecessor);
+
+        Vertex *v = label->GetVertex();
+        Vertex *w = predecessor->GetVertex();
+        if (v == w) {
+            stack.push_back(_label_table->GetLabel(v->GetId(), 
+                label->GetBitset() & ~predecessor->GetBitset()));
+            continue;
+        }
+        AppendSegments(w, v, ret_segments);
+        if (++degrees[v->GetId()] == 3)
+            ret_steiner_points.push_back(v);
+        if (++degrees[w->GetId()] == 3)
+            ret_steiner_points.push_back(w);
+    }
+    return SUCCESS;
+}
+
+int Solver::GetGlobalUpperBound() const { return _global_upper_bound; }
+
+int Solver::GetMSTUpperBound() const { return _MST_upper_bound; }
+
+int Solver::GetNEliminatedVertices() const { return _n_eliminated; }
+
+long Solver::GetNLabels() const { return _label_store->GetNLabels(); }
+
+long Solver::GetNRetiredLabels() const { return _n_retired; }
+
+uint64_t Solver::GetLabelTableMemoryUsage() const {
+    return _label_table->GetMemoryUsage();
+}
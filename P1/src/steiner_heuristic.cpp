@@ -0,0 +1,223 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * steiner_heuristic.cpp
+ *
+ *
+ * Implementation of functionality described in steiner_heuristic.hpp.
+ */
+
+#include "steiner_heuristic.hpp"
+
+#include <algorithm>
+#include <climits>
+
+using namespace std;
+
+/* Find the representative of i in a union-find structure without ranks,
+ * halving paths along the way. */
+static int FindRoot(vector<int> &parents, int i) {
+    while (parents[i] != i) {
+        parents[i] = parents[parents[i]];
+        i = parents[i];
+    }
+    return i;
+}
+
+SteinerHeuristic::SteinerHeuristic(Instance *problem_instance) {
+    _problem_instance = problem_instance;
+    _n_terminals = problem_instance->GetNTerminals();
+    _length = 0;
+}
+
+Result SteinerHeuristic::ComputeMST() {
+    int k = _points.size();
+    vector<int> costs(k, INT_MAX);
+    vector<bool> in_tree(k, false);
+    _parents.assign(k, -1);
+    _edges.clear();
+    _length = 0;
+
+    costs[0] = 0;
+    for (int n = 0; n < k; n++) {
+        int u = -1;
+        for (int i = 0; i < k; i++) {
+            if (!in_tree[i] && (u < 0 || costs[i] < costs[u]))
+                u = i;
+        }
+        in_tree[u] = true;
+        if (_parents[u] >= 0) {
+            HeuristicEdge e = { costs[u], _parents[u], u };
+            _edges.push_back(e);
+            _length += costs[u];
+        }
+        for (int i = 0; i < k; i++) {
+            int d = RectDistance(_points[u], _points[i]);
+            if (!in_tree[i] && d < costs[i]) {
+                costs[i] = d;
+                _parents[i] = u;
+            }
+        }
+    }
+
+    sort(_edges.begin(), _edges.end(),
+         [](const HeuristicEdge &e, const HeuristicEdge &f) {
+        return e._length < f._length;
+    });
+    return SUCCESS;
+}
+
+int SteinerHeuristic::Gain(Vertex *c) const {
+    int k = _points.size();
+    vector<int> dists(k);
+    vector<int> order(k);
+    for (int i = 0; i < k; i++) {
+        dists[i] = RectDistance(c, _points[i]);
+        order[i] = i;
+    }
+    sort(order.begin(), order.end(), [&](int i, int j) {
+        return dists[i] < dists[j];
+    });
+
+    /* Merge the edges of the MST on P with the edges at c (the point
+     * with position k) in increasing order of length. */
+    vector<int> components(k + 1);
+    for (int i = 0; i <= k; i++)
+        components[i] = i;
+    int length = 0, n_edges = 0;
+    unsigned int e = 0;
+    int j = 0;
+    while (n_edges < k) {
+        int a, b, d;
+        if (j >= k || (e < _edges.size() &&
+                       _edges[e]._length <= dists[order[j]])) {
+            a = _edges[e]._a;
+            b = _edges[e]._b;
+            d = _edges[e]._length;
+            e++;
+        }
+        else {
+            a = order[j];
+            b = k;
+            d = dists[order[j]];
+            j++;
+        }
+        int root_a = FindRoot(components, a);
+        int root_b = FindRoot(components, b);
+        if (root_a == root_b)
+            continue;
+        components[root_a] = root_b;
+        length += d;
+        n_edges++;
+    }
+    return _length - length;
+}
+
+int SteinerHeuristic::RemoveSteinerPoints() {
+    int n_removed = 0;
+    bool removed = true;
+    while (removed) {
+        removed = false;
+        vector<int> degrees(_points.size(), 0);
+        for (unsigned int e = 0; e < _edges.size(); e++) {
+            degrees[_edges[e]._a]++;
+            degrees[_edges[e]._b]++;
+        }
+        for (unsigned int i = _n_terminals; i < _points.size(); i++) {
+            if (degrees[i] <= 2) {
+                _points.erase(_points.begin() + i);
+                ComputeMST();
+                n_removed++;
+                removed = true;
+                break;
+            }
+        }
+    }
+    return n_removed;
+}
+
+Result SteinerHeuristic::ComputeSubtrees() {
+    int k = _points.size();
+    _subtree_masks.assign(k, 0);
+    _subtree_lengths.assign(k, 0);
+
+    /* Order the points such that each point comes after its parent. */
+    vector<vector<int> > children(k);
+    for (int i = 1; i < k; i++)
+        children[_parents[i]].push_back(i);
+    vector<int> order(1, 0);
+    for (unsigned int n = 0; n < order.size(); n++) {
+        const vector<int> &c = children[order[n]];
+        order.insert(order.end(), c.begin(), c.end());
+    }
+
+    for (int n = k - 1; n >= 0; n--) {
+        int i = order[n];
+        if (i < _n_terminals)
+            _subtree_masks[i] |= (uint64_t) 1 << i;
+        if (i == 0)
+            continue;
+        int p = _parents[i];
+        _subtree_masks[p] |= _subtree_masks[i];
+        _subtree_lengths[p] += _subtree_lengths[i] +
+                               RectDistance(_points[i], _points[p]);
+    }
+    return SUCCESS;
+}
+
+Result SteinerHeuristic::Run() {
+    Vertex **terminals = _problem_instance->GetTerminals();
+    _points.assign(terminals, terminals + _n_terminals);
+    ComputeMST();
+
+    const vector<Vertex*> &vertices = _problem_instance->GetVertices();
+    for (int round = 0; round < HEURISTIC_MAX_ROUNDS; round++) {
+        /* Find all candidates with positive gain, ordered by decreasing
+         * gain, and by position among candidates with the same gain. */
+        vector<pair<int, int> > gains;
+        for (unsigned int i = 0; i < vertices.size(); i++) {
+            if (find(_points.begin(), _points.end(), vertices[i]) !=
+                _points.end())
+                continue;
+            int gain = Gain(vertices[i]);
+            if (gain > 0)
+                gains.push_back(make_pair(-gain, i));
+        }
+        sort(gains.begin(), gains.end());
+
+        int n_added = 0;
+        for (unsigned int i = 0; i < gains.size(); i++) {
+            Vertex *c = vertices[gains[i].second];
+            if (Gain(c) <= 0)
+                continue;
+            _points.push_back(c);
+            ComputeMST();
+            n_added++;
+        }
+        RemoveSteinerPoints();
+        if (n_added == 0)
+            break;
+    }
+
+    ComputeSubtrees();
+    return SUCCESS;
+}
+
+int SteinerHeuristic::GetLength() const { return _length; }
+
+int SteinerHeuristic::GetNPoints() const { return _points.size(); }
+
+Vertex *SteinerHeuristic::GetPoint(int i) const { return _points[i]; }
+
+int SteinerHeuristic::GetParent(int i) const { return _parents[i]; }
+
+uint64_t SteinerHeuristic::GetSubtreeMask(int i) const {
+    return _subtree_masks[i];
+}
+
+int SteinerHeuristic::GetSubtreeLength(int i) const {
+    return _subtree_lengths[i];
+}
@@ -0,0 +1,106 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * subset_prefetcher.cpp
+ *
+ *
+ * Implementation of functionality described in subset_prefetcher.hpp.
+ */
+
+#include "subset_prefetcher.hpp"
+
+using namespace std;
+
+SubsetPrefetcher::SubsetPrefetcher(
+        const function<void(PrefetchedSubset&)> &compute) {
+    _compute = compute;
+    _stop = false;
+    _has_results = false;
+    _worker = thread(&SubsetPrefetcher::WorkerLoop, this);
+}
+
+SubsetPrefetcher::~SubsetPrefetcher() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _work_cv.notify_one();
+    _worker.join();
+}
+
+void SubsetPrefetcher::WorkerLoop() {
+    vector<uint64_t> work;
+    vector<PrefetchedSubset> done;
+    while (true) {
+        {
+            unique_lock<mutex> lock(_mutex);
+            _work_cv.wait(lock, [&] { return _stop || !_queue.empty(); });
+            if (_stop)
+                return;
+            work.swap(_queue);
+        }
+
+        done.resize(work.size());
+        for (unsigned int i = 0; i < work.size(); i++) {
+            done[i]._mask = work[i];
+            _compute(done[i]);
+        }
+        work.clear();
+
+        {
+            lock_guard<mutex> lock(_mutex);
+            _results.insert(_results.end(), done.begin(), done.end());
+            _has_results.store(true, memory_order_release);
+        }
+    }
+}
+
+Result SubsetPrefetcher::Flush() {
+    bool dropped = false;
+    {
+        lock_guard<mutex> lock(_mutex);
+        if (_queue.size() < PREFETCH_MAX_QUEUE)
+            _queue.insert(_queue.end(), _batch.begin(), _batch.end());
+        else
+            dropped = true;
+    }
+
+    /* Dropped terminal sets may be submitted again later. */
+    if (dropped) {
+        for (unsigned int i = 0; i < _batch.size(); i++)
+            _submitted.erase(_batch[i]);
+    }
+    else
+        _work_cv.notify_one();
+    _batch.clear();
+    return dropped ? FAIL : SUCCESS;
+}
+
+Result SubsetPrefetcher::Submit(uint64_t I) {
+    if (!_submitted.insert(I).second)
+        return FAIL;
+    _batch.push_back(I);
+    if (_batch.size() >= PREFETCH_BATCH)
+        Flush();
+    return SUCCESS;
+}
+
+Result SubsetPrefetcher::Collect(vector<PrefetchedSubset> &ret_results) {
+    if (!_has_results.load(memory_order_acquire))
+        return FAIL;
+
+    unsigned int begin = ret_results.size();
+    {
+        lock_guard<mutex> lock(_mutex);
+        ret_results.insert(ret_results.end(), _results.begin(),
+                           _results.end());
+        _results.clear();
+        _has_results.store(false, memory_order_relaxed);
+    }
+    for (unsigned int i = begin; i < ret_results.size(); i++)
+        _submitted.erase(ret_results[i]._mask);
+    return SUCCESS;
+}
@@ -0,0 +1,169 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * subset_table.cpp
+ *
+ *
+ * Implementation of functionality described in subset_table.hpp.
+ */
+
+#include "subset_table.hpp"
+
+#include <iostream>
+
+using namespace std;
+
+SubsetTable::SubsetTable(bool dense, int n_terminals) {
+    _dense = dense;
+    if (!_dense) {
+        _capacity = SUBSET_TABLE_MIN_CAPACITY;
+        _n_records = 0;
+        _records = AllocateRecords(_capacity);
+        return;
+    }
+
+    /* The record for I is at position I / 2, since I never contains
+     * the root. */
+    _capacity = (uint64_t) 1 << (n_terminals - 1);
+    _n_records = _capacity;
+    _records = AllocateRecords(_capacity);
+    for (uint64_t i = 0; i < _capacity; i++)
+        ClearRecord(_records[i], i << 1);
+}
+
+SubsetTable::~SubsetTable() {
+    free(_records);
+}
+
+SubsetRecord *SubsetTable::AllocateRecords(uint64_t capacity) const {
+    SubsetRecord *records = (SubsetRecord*) aligned_alloc(64, 
+                                capacity * sizeof(SubsetRecord));
+    if (records == NULL) {
+        cout << "ERROR: Failed to allocate memory for subset table.\n";
+        exit(1);
+    }
+    for (uint64_t i = 0; i < capacity; i++)
+        records[i]._mask = SUBSET_EMPTY_KEY;
+    return records;
+}
+
+void SubsetTable::ClearRecord(SubsetRecord &r, uint64_t I) const {
+    r._mask = I;
+    r._S = 0;
+    r._U = SUBSET_NO_UPPER_BOUND;
+    r._distance = SUBSET_NOT_COMPUTED;
+    r._distance_ind = SUBSET_NOT_COMPUTED;
+    r._MST = SUBSET_NOT_COMPUTED;
+}
+
+uint64_t SubsetTable::DenseMemoryUsage(int n_terminals) {
+    return ((uint64_t) 1 << (n_terminals - 1)) * sizeof(SubsetRecord);
+}
+
+uint64_t SubsetTable::Hash(uint64_t I) const {
+    uint64_t h = I;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h & (_capacity - 1);
+}
+
+Result SubsetTable::Grow() {
+    SubsetRecord *old_records = _records;
+    uint64_t old_capacity = _capacity;
+
+    _capacity *= 2;
+    _records = AllocateRecords(_capacity);
+    for (uint64_t i = 0; i < old_capacity; i++) {
+        if (old_records[i]._mask == SUBSET_EMPTY_KEY)
+            continue;
+        uint64_t pos = Hash(old_records[i]._mask);
+        while (_records[pos]._mask != SUBSET_EMPTY_KEY)
+            pos = (pos + 1) & (_capacity - 1);
+        _records[pos] = old_records[i];
+    }
+    free(old_records);
+    return SUCCESS;
+}
+
+SubsetRecord *SubsetTable::Find(uint64_t I) const {
+    if (_dense)
+        return _records + (I >> 1);
+
+    uint64_t pos = Hash(I);
+    while (_records[pos]._mask != SUBSET_EMPTY_KEY) {
+        if (_records[pos]._mask == I)
+            return _records + pos;
+        pos = (pos + 1) & (_capacity - 1);
+    }
+    return NULL;
+}
+
+SubsetRecord *SubsetTable::FindOrInsert(uint64_t I) {
+    if (_dense)
+        return _records + (I >> 1);
+
+    uint64_t pos = Hash(I);
+    while (_records[pos]._mask != SUBSET_EMPTY_KEY) {
+        if (_records[pos]._mask == I)
+            return _records + pos;
+        pos = (pos + 1) & (_capacity - 1);
+    }
+
+    /* Not found, so make room if needed and insert a new record. */
+    if ((_n_records + 1) * 100 > _capacity * SUBSET_TABLE_MAX_LOAD) {
+        Grow();
+        pos = Hash(I);
+        while (_records[pos]._mask != SUBSET_EMPTY_KEY)
+            pos = (pos + 1) & (_capacity - 1);
+    }
+
+    ClearRecord(_records[pos], I);
+    _n_records ++;
+    return _records + pos;
+}
+
+uint64_t SubsetTable::GetNRecords() const { return _n_records; }
+
+uint64_t SubsetTable::GetCapacity() const { return _capacity; }
+
+double SubsetTable::GetAverageProbeLength() const {
+    /* A record at distance k from the position of its hash is found 
+     * after probing k + 1 records. */
+    if (_n_records == 0)
+        return 0;
+    if (_dense)
+        return 1;
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < _capacity; i++) {
+        if (_records[i]._mask != SUBSET_EMPTY_KEY)
+            total += ((i - Hash(_records[i]._mask)) & (_capacity - 1)) + 1;
+    }
+    return (double) total / _n_records;
+}
+
+uint64_t SubsetTable::GetMaxProbeLength() const {
+    if (_dense)
+        return 1;
+    uint64_t max = 0;
+    for (uint64_t i = 0; i < _capacity; i++) {
+        if (_records[i]._mask == SUBSET_EMPTY_KEY)
+            continue;
+        uint64_t length = 
+            ((i - Hash(_records[i]._mask)) & (_capacity - 1)) + 1;
+        if (length > max)
+            max = length;
+    }
+    return max;
+}
+
+uint64_t SubsetTable::GetMemoryUsage() const {
+    return _capacity * sizeof(SubsetRecord);
+}
+
+bool SubsetTable::IsDense() const { return _dense; }
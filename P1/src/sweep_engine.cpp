@@ -0,0 +1,155 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * sweep_engine.cpp
+ *
+ *
+ * Implementation of functionality described in sweep_engine.hpp.
+ */
+
+#include "sweep_engine.hpp"
+
+#include <algorithm>
+
+using namespace std;
+
+/* Fill coords with the distinct coordinates of the terminals of the given
+ * instance along each axis in increasing order, and return the number of
+ * vertices of their Hanan grid. */
+static uint64_t SetGridCoords(Instance *problem_instance,
+                              vector<int> *coords) {
+    Vertex **terminals = problem_instance->GetTerminals();
+    uint64_t n_cells = 1;
+    for (int axis = 0; axis < 3; axis++) {
+        coords[axis].clear();
+        for (int t = 0; t < problem_instance->GetNTerminals(); t++) {
+            Vertex *v = terminals[t];
+            coords[axis].push_back(axis == 0 ? v->GetX() :
+                                   axis == 1 ? v->GetY() : v->GetZ());
+        }
+        sort(coords[axis].begin(), coords[axis].end());
+        coords[axis].erase(unique(coords[axis].begin(), coords[axis].end()),
+                           coords[axis].end());
+        n_cells *= coords[axis].size();
+    }
+    return n_cells;
+}
+
+SweepEngine::SweepEngine(Instance *problem_instance) {
+    _problem_instance = problem_instance;
+    _n_terminals = problem_instance->GetNTerminals();
+    _n_cells = SetGridCoords(problem_instance, _coords);
+    _length = 0;
+
+    Vertex **terminals = problem_instance->GetTerminals();
+    for (int t = 0; t < _n_terminals; t++) {
+        int pos[3] = { terminals[t]->GetX(), terminals[t]->GetY(),
+                       terminals[t]->GetZ() };
+        for (int axis = 0; axis < 3; axis++)
+            pos[axis] = lower_bound(_coords[axis].begin(),
+                                    _coords[axis].end(), pos[axis]) -
+                        _coords[axis].begin();
+        _terminal_cells.push_back((pos[0] * (int) _coords[1].size() +
+                                   pos[1]) * (int) _coords[2].size() +
+                                  pos[2]);
+    }
+}
+
+uint64_t SweepEngine::MemoryUsage(Instance *problem_instance) {
+    vector<int> coords[3];
+    uint64_t n_cells = SetGridCoords(problem_instance, coords);
+    int n = problem_instance->GetNTerminals();
+    if (n < 1 || n > BITSET_SIZE - 1)
+        return UINT64_MAX;
+    return ((uint64_t) 1 << (n - 1)) * n_cells * sizeof(int32_t);
+}
+
+Result SweepEngine::Sweep(int32_t *values) const {
+    int n_x = _coords[0].size(), n_y = _coords[1].size();
+    int n_z = _coords[2].size();
+    int plane = n_y * n_z;
+
+    /* Along x and y, whole planes or rows are swept at once, so that the
+     * inner loops run over consecutive values. */
+    for (int i = 1; i < n_x; i++) {
+        int gap = _coords[0][i] - _coords[0][i - 1];
+        int32_t *cur = values + i * plane, *prev = cur - plane;
+        for (int c = 0; c < plane; c++)
+            cur[c] = min(cur[c], prev[c] + gap);
+    }
+    for (int i = n_x - 2; i >= 0; i--) {
+        int gap = _coords[0][i + 1] - _coords[0][i];
+        int32_t *cur = values + i * plane, *next = cur + plane;
+        for (int c = 0; c < plane; c++)
+            cur[c] = min(cur[c], next[c] + gap);
+    }
+
+    for (int i = 0; i < n_x; i++) {
+        int32_t *block = values + i * plane;
+        for (int j = 1; j < n_y; j++) {
+            int gap = _coords[1][j] - _coords[1][j - 1];
+            int32_t *cur = block + j * n_z, *prev = cur - n_z;
+            for (int k = 0; k < n_z; k++)
+                cur[k] = min(cur[k], prev[k] + gap);
+        }
+        for (int j = n_y - 2; j >= 0; j--) {
+            int gap = _coords[1][j + 1] - _coords[1][j];
+            int32_t *cur = block + j * n_z, *next = cur + n_z;
+            for (int k = 0; k < n_z; k++)
+                cur[k] = min(cur[k], next[k] + gap);
+        }
+    }
+
+    for (int line = 0; line < n_x * n_y; line++) {
+        int32_t *cur = values + line * n_z;
+        for (int k = 1; k < n_z; k++)
+            cur[k] = min(cur[k], cur[k - 1] + _coords[2][k] -
+                                 _coords[2][k - 1]);
+        for (int k = n_z - 2; k >= 0; k--)
+            cur[k] = min(cur[k], cur[k + 1] + _coords[2][k + 1] -
+                                 _coords[2][k]);
+    }
+    return SUCCESS;
+}
+
+Result SweepEngine::Run() {
+    _length = 0;
+    if (_n_terminals < 2)
+        return SUCCESS;
+
+    /* Terminal sets are masks of R - {root} shifted down by one bit. */
+    uint64_t n_sets = (uint64_t) 1 << (_n_terminals - 1);
+    _values.assign(n_sets * _n_cells, SWEEP_INFINITY);
+
+    for (uint64_t I = 1; I < n_sets; I++) {
+        int32_t *values = _values.data() + I * _n_cells;
+        uint64_t low = I & (~I + 1);
+        if (I == low) {
+            values[_terminal_cells[__builtin_ctzll(I) + 1]] = 0;
+            Sweep(values);
+            continue;
+        }
+
+        /* Merge-step: each split {J, I - J} is found once by only taking
+         * the J that contain the lowest terminal of I. */
+        uint64_t rest = I ^ low;
+        for (uint64_t S = (rest - 1) & rest; ; S = (S - 1) & rest) {
+            uint64_t J = S | low;
+            const int32_t *a = _values.data() + J * _n_cells;
+            const int32_t *b = _values.data() + (I ^ J) * _n_cells;
+            for (int c = 0; c < _n_cells; c++)
+                values[c] = min(values[c], a[c] + b[c]);
+            if (S == 0)
+                break;
+        }
+        Sweep(values);
+    }
+
+    _length = _values[(n_sets - 1) * _n_cells + _terminal_cells[0]];
+    return SUCCESS;
+}
+
+int SweepEngine::GetLength() const { return _length; }
@@ -0,0 +1,86 @@
+/* Lucas Slot (lfh.slot@gmail.com)
+ * Ardalan Khazraei (ardalan.khazraei@gmail.com)
+ *
+ * June 2017
+ * University of Bonn
+ *
+ * thread_pool.cpp
+ *
+ *
+ * Implementation of functionality described in thread_pool.hpp.
+ */
+
+#include "thread_pool.hpp"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int n_threads) {
+    _n_threads = (n_threads < 1) ? 1 : n_threads;
+    _task = NULL;
+    _round = 0;
+    _n_busy = 0;
+    _stop = false;
+
+    for (int t = 1; t < _n_threads; t++)
+        _workers.push_back(thread(&ThreadPool::WorkerLoop, this, t));
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stop = true;
+    }
+    _start_cv.notify_all();
+    for (unsigned int i = 0; i < _workers.size(); i++)
+        _workers[i].join();
+}
+
+void ThreadPool::WorkerLoop(int thread_id) {
+    uint64_t last_round = 0;
+    while (true) {
+        const function<void(int)> *task;
+        {
+            unique_lock<mutex> lock(_mutex);
+            _start_cv.wait(lock, [&] { 
+                return _stop || _round != last_round; 
+            });
+            if (_stop)
+                return;
+            last_round = _round;
+            task = _task;
+        }
+
+        (*task)(thread_id);
+
+        {
+            lock_guard<mutex> lock(_mutex);
+            if (--_n_busy == 0)
+                _done_cv.notify_one();
+        }
+    }
+}
+
+Result ThreadPool::Run(const function<void(int)> &task) {
+    if (_n_threads == 1) {
+        task(0);
+        return SUCCESS;
+    }
+
+    {
+        lock_guard<mutex> lock(_mutex);
+        _task = &task;
+        _n_busy = _n_threads - 1;
+        _round ++;
+    }
+    _start_cv.notify_all();
+
+    task(0);
+
+    /* Wait for the workers, so that task can safely go out of scope. */
+    unique_lock<mutex> lock(_mutex);
+    _done_cv.wait(lock, [&] { return _n_busy == 0; });
+    _task = NULL;
+    return SUCCESS;
+}
+
+int ThreadPool::GetNThreads() const { return _n_threads; }
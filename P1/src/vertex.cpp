@@ -20,14 +20,13 @@ Vertex::Vertex(int x, int y, int z) {
     _z = z;
     _n_neigh = 0;
     _n_labels = 0;
+    _n_retired = 0;
     _is_root = false;
 }
 
 Vertex::~Vertex() {
-    for (int i = 0; i < _n_labels; i++) {
-        delete _labels[i];
-    }
-    _label_hash.clear();
+    /* The labels themselves are owned by the LabelStore of the 
+     * solver, so there is nothing to free here. */
 }
 
 Result Vertex::AddNeighbour(Vertex* w) {
@@ -36,13 +35,66 @@ Result Vertex::AddNeighbour(Vertex* w) {
     return SUCCESS;
 }
 
+Result Vertex::RemoveNeighbour(Vertex* w) {
+    for (int i = 0; i < _n_neigh; i++) {
+        if (_neigh[i] == w) {
+            _neigh.erase(_neigh.begin() + i);
+            _n_neigh --;
+            return SUCCESS;
+        }
+    }
+    return FAIL;
+}
+
+Result Vertex::ReplaceNeighbour(Vertex* old_w, Vertex* w) {
+    for (int i = 0; i < _n_neigh; i++) {
+        if (_neigh[i] == old_w) {
+            _neigh[i] = w;
+            return SUCCESS;
+        }
+    }
+    return FAIL;
+}
+
+bool Vertex::HasNeighbour(Vertex* w) const {
+    for (int i = 0; i < _n_neigh; i++) {
+        if (_neigh[i] == w)
+            return true;
+    }
+    return false;
+}
+
 Result Vertex::AddLabel(Label *l) {
     _labels.push_back(l);
-    _label_hash.insert(make_pair(l->GetBitset(), _n_labels));
     _n_labels ++;
     return SUCCESS;
 }
 
+Result Vertex::RetireLabel(vector<Label*> &ret_removed) {
+    _n_retired ++;
+    if (VERTEX_COMPACT_FRACTION * _n_retired < _n_labels)
+        return SUCCESS;
+
+    int n_kept = 0;
+    for (int i = 0; i < _n_labels; i++) {
+        if (_labels[i]->IsRetired())
+            ret_removed.push_back(_labels[i]);
+        else
+            _labels[n_kept++] = _labels[i];
+    }
+    _labels.resize(n_kept);
+    _labels.shrink_to_fit();
+    _n_labels = n_kept;
+    _n_retired = 0;
+    return SUCCESS;
+}
+
+Result Vertex::AddPermanentLabel(Label *l) {
+    _P_masks.push_back(l->GetBitset().to_ullong());
+    _P_values.push_back(l->GetL());
+    return SUCCESS;
+}
+
 bool Vertex::HasCoords(int x, int y, int z) const {
     return (_x == x && _y == y && _z == z);
 }
@@ -62,11 +114,16 @@ const int& Vertex::GetId() const {
 
 bool Vertex::IsRoot() const { return _is_root; } 
 
+Result Vertex::ResetId() {
+    _id = -1;
+    return SUCCESS;
+}
+
 Result Vertex::SetId(int id) {
     if (id < 0)
         return FAIL;
     else {
-        if (_id >= 0) {
+        if (_id < 0) {
             _id = id;
             return SUCCESS;
         }
@@ -90,15 +147,9 @@ const vector<Vertex*> &Vertex::GetNeighbours() const { return _neigh; }
 
 const vector<Label*> &Vertex::GetLabels() const { return _labels; }
 
-Label *Vertex::GetLabelByBitset(const bitset<BITSET_SIZE> &I) const {
-    auto it = _label_hash.find(I);
-    if (it != _label_hash.end()) {
-        return _labels[it->second];
-    }
-    else {
-        return NULL;
-    }
-}
+const vector<uint64_t> &Vertex::GetPermanentMasks() const { return _P_masks; }
+
+const vector<int> &Vertex::GetPermanentValues() const { return _P_values; }
 
 bool Vertex::operator==(const Vertex& other) { 
     return _id == other.GetId();
@@ -1,59 +1,75 @@
 # Assert whether the binary ./bin/main produces the correct result for a series
 # of instances of the 3D rectilinear steiner tree problem for which the correct
-# answer is known.
+# answer is known. Every instance is solved once for each of the modes below.
 
 import commands
 
 bpath = './bin/main'
 tfpath = './testing/cases/assertion/'
+rfpath = './testing/cases/regression/'
+
+# Options the binary is run with. The first one is the default mode.
+modes = ['',
+         'BB', 'OT', 'ALL', 'DA', 'AUTO', 'NONE',
+         '--queue heap',
+         'ALL --lazy on', 'DA --lazy on',
+         'ALL --lazy on --queue heap', 'DA --lazy on --queue heap',
+         '--reduce off', '--eliminate on', 'DA --eliminate off',
+         '--heuristic off',
+         '--prefetch on', 'ALL --prefetch on',
+         '--sweep on',
+         '--threads 4', '--nearest eager', '--nearest lazy',
+         '--dense off', '--dense eager', '--simd scalar',
+         '--tree', '--stats']
+
+cases = []
 
 # First set of tests.
 correct_output = ['2598', '3048', '2772', '3389', '4035', '4060']
 for i in range(5, 11):
-    output = commands.getstatusoutput(bpath + ' ' + tfpath + '/test_' + str(i))[1]
-    if not (output == correct_output[i - 5]):
-        print "Test failed for test" + str(i)
-        print output, correct_output[i - 5]
-    else:
-        print "Test succeeded for test" + str(i)
+    cases.append(('test' + str(i), tfpath + '/test_' + str(i),
+                  correct_output[i - 5]))
 
 # Second set of tests.
 correct_output = ['2128', '3008', '3033', '3474', '3090', '3773']
 for i in range(5, 11):
-    output = commands.getstatusoutput(bpath + ' ' + tfpath + '/testA_' + str(i))[1]
-    if not (output == correct_output[i - 5]):
-        print "Test failed for testA" + str(i)
-        print output, correct_output[i - 5]
-    else:
-        print "Test succeeded for testA" + str(i)
+    cases.append(('testA' + str(i), tfpath + '/testA_' + str(i),
+                  correct_output[i - 5]))
 
 # Third set of tests.
 correct_output = ['1960', '2003', '2541', '4212', '4154', '3710']
 for i in range(5, 11):
-    output = commands.getstatusoutput(bpath + ' ' + tfpath + '/testB_' + str(i))[1]
-    if not (output == correct_output[i - 5]):
-        print "Test failed for testB" + str(i)
-        print output, correct_output[i - 5]
-    else:
-        print "Test succeeded for testB" + str(i)
+    cases.append(('testB' + str(i), tfpath + '/testB_' + str(i),
+                  correct_output[i - 5]))
 
 # Fourth set of tests.
 correct_output = ['2605', '2988', '3177', '2974', '3259', '4136']
 for i in range(5, 11):
-    output = commands.getstatusoutput(bpath + ' ' + tfpath + '/testC_' + str(i))[1]
-    if not (output == correct_output[i - 5]):
-        print "Test failed for testC" + str(i)
-        print output, correct_output[i - 5]
-    else:
-        print "Test succeeded for testC" + str(i)
-
+    cases.append(('testC' + str(i), tfpath + '/testC_' + str(i),
+                  correct_output[i - 5]))
 
 # Given instances.
 correct_output = ['971', '1932', '1645', '2235', '3504']
 for i in range(1, 6):
-    output = commands.getstatusoutput(bpath + ' ' + tfpath + 'given/i0' + str(i))[1]
-    if not (output == correct_output[i - 1]):
-        print "Test failed for i0" + str(i)
-        print output, correct_output[i - 1]
-    else:
-        print "Test succeeded for i0" + str(i)
+    cases.append(('i0' + str(i), tfpath + 'given/i0' + str(i),
+                  correct_output[i - 1]))
+
+# Regression instances, which once gave a wrong result in some mode.
+cases.append(('lazy_heap_11', rfpath + 'lazy_heap_11', '3663'))
+cases.append(('single_terminal', rfpath + 'single_terminal', '0'))
+
+n_failed = 0
+for mode in modes:
+    for name, path, correct in cases:
+        # Only the output, not the log on stderr, is compared. --tree and
+        # --stats print the length on the first line.
+        output = commands.getstatusoutput(bpath + ' ' + path + ' ' + mode +
+                                          ' 2> /dev/null')[1].split('\n')[0]
+        if not (output == correct):
+            print "Test failed for " + name + " [" + mode + "]"
+            print output, correct
+            n_failed += 1
+        else:
+            print "Test succeeded for " + name + " [" + mode + "]"
+
+print str(n_failed) + " of " + str(len(modes) * len(cases)) + " tests failed"